@@ -0,0 +1,124 @@
+#!/bin/bash
+#
+# makeFarm.sh
+# Creates a set of repositories for benchmarking gitUpdater.  Each repository
+# has a local bare remote (file:// URL), a history of the requested depth and
+# the requested number of branches.  Repositories are given a mix of states:
+# clean, dirty, local ahead, remote ahead and a second remote.
+#
+# Usage:  makeFarm.sh <directory> <repositories> <branches> <commits> <dirty percent>
+#
+# The pristine farm is kept in <directory>/pristine and is only rebuilt when
+# the parameters change.  Each call copies it to <directory>/run, since
+# running gitUpdater pushes to the remotes.
+
+set -e
+
+if [ $# -ne 5 ]; then
+	echo "Usage:  $0 <directory> <repositories> <branches> <commits> <dirty percent>" >&2
+	exit 1
+fi
+
+DIR=$(mkdir -p "$1" && cd "$1" && pwd)
+REPOS=$2
+BRANCHES=$3
+COMMITS=$4
+DIRTY=$5
+PARAMS="$REPOS $BRANCHES $COMMITS $DIRTY"
+
+export GIT_AUTHOR_NAME=bench GIT_AUTHOR_EMAIL=bench@example.com
+export GIT_COMMITTER_NAME=bench GIT_COMMITTER_EMAIL=bench@example.com
+export GIT_CONFIG_NOSYSTEM=1
+
+# Writes a fast-import stream with a linear history on master and branches
+# that split off at evenly spaced points
+historyStream()
+{
+	local i b
+	for ((i = 1; i <= COMMITS; i++)); do
+		echo "commit refs/heads/master"
+		echo "mark :$i"
+		echo "committer bench <bench@example.com> $((1500000000 + i)) +0000"
+		echo "data <<EOF"
+		echo "commit $i"
+		echo "EOF"
+		echo "M 644 inline file$((i % 16)).txt"
+		echo "data <<EOF"
+		echo "line $i"
+		echo "EOF"
+		echo
+	done
+
+	for ((b = 1; b < BRANCHES; b++)); do
+		echo "reset refs/heads/branch$b"
+		echo "from :$(( (b * COMMITS) / BRANCHES > 0 ? (b * COMMITS) / BRANCHES : 1 ))"
+		echo
+	done
+}
+
+createRepository()
+{
+	local n=$1
+	local name=$(printf "repo%05d" $n)
+	local remote="$DIR/pristine/remotes/$name.git"
+	local work="$DIR/pristine/repos/$name"
+
+	git init -q --bare "$remote"
+	historyStream | git -C "$remote" fast-import --quiet
+	git clone -q "file://$remote" "$work"
+
+	# Track every remote branch locally so each one gets compared
+	git -C "$work" for-each-ref --format="create refs/heads/%(refname:lstrip=3) %(objectname)" \
+		"refs/remotes/origin/branch*" | git -C "$work" update-ref --stdin
+
+	case $((n % 7)) in
+	1)
+		echo ahead > "$work/ahead.txt"
+		git -C "$work" add ahead.txt
+		git -C "$work" commit -q -m ahead
+		;;
+	2)
+		echo behind > "$work/behind.txt"
+		git -C "$work" add behind.txt
+		git -C "$work" commit -q -m behind
+		git -C "$work" push -q origin master
+		git -C "$work" reset -q --hard HEAD~1
+		;;
+	3)
+		git -C "$work" remote add mirror "file://$remote"
+		git -C "$work" fetch -q mirror
+		;;
+	esac
+
+	if [ $(( (n * 37) % 100 )) -lt "$DIRTY" ]; then
+		echo dirty >> "$work/file0.txt"
+		echo untracked > "$work/untracked.txt"
+	fi
+}
+
+if [ ! -f "$DIR/pristine/params" ] || [ "$(cat "$DIR/pristine/params")" != "$PARAMS" ]; then
+	echo "Creating $REPOS repositories with $BRANCHES branches and $COMMITS commits in $DIR/pristine"
+	rm -rf "$DIR/pristine"
+	mkdir -p "$DIR/pristine/remotes" "$DIR/pristine/repos"
+	pids=()
+	for ((n = 0; n < REPOS; n++)); do
+		createRepository $n &
+		pids+=($!)
+		if (( ${#pids[@]} == 8 || n + 1 == REPOS )); then
+			for pid in "${pids[@]}"; do
+				if ! wait "$pid"; then
+					echo "Failed to create repository" >&2
+					exit 1
+				fi
+			done
+			pids=()
+		fi
+	done
+	echo "$PARAMS" > "$DIR/pristine/params"
+fi
+
+# Remote URLs are absolute, so they are rewritten to point at the copy
+rm -rf "$DIR/run"
+cp -a "$DIR/pristine" "$DIR/run"
+find "$DIR/run/repos" -maxdepth 3 -name config -path "*/.git/config" \
+	-exec sed -i "s|$DIR/pristine/|$DIR/run/|g" {} +
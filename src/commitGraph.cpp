@@ -0,0 +1,271 @@
+// File:  commitGraph.cpp
+// Date:  10/18/2026
+// Auth:  agent
+// Desc:  Reads a repository's commit-graph.
+
+// Standard C/C++ headers
+#include <cstring>
+#include <fstream>
+
+// Local headers
+#include "commitGraph.h"
+#include "objectStore.h"
+
+const uint32_t CommitGraph::noGeneration(UINT32_MAX);
+
+static const size_t idLength(20);
+static const size_t commitDataSize(idLength + 16);
+static const uint32_t noParent(0x70000000);
+static const uint32_t extraEdgesFlag(0x80000000);
+
+CommitGraph::CommitGraph(const std::string& commonDirectory)
+	: objectDirectory(commonDirectory + "objects/"), loaded(false)
+{
+}
+
+CommitGraph::~CommitGraph()
+{
+	unsigned int i;
+	for (i = 0; i < layers.size(); i++)
+		ObjectStore::UnmapFile(layers[i].data, layers[i].size);
+}
+
+bool CommitGraph::Lookup(const std::string& commitId, std::vector<std::string>& parents,
+	int64_t& commitTime, uint32_t& generation)
+{
+	if (!loaded)
+		Load();
+
+	uint32_t position;
+	if (!FindPosition(commitId, position))
+		return false;
+
+	const Layer* layer(FindLayer(position));
+	const unsigned char* entry(layer->commitData +
+		(position - layer->firstPosition) * commitDataSize);
+
+	// Tree ID, first parent, second parent (or the start of a list of the
+	// rest), then a 30-bit generation number and 34-bit commit time
+	parents.clear();
+	const uint32_t firstParent(ReadBigEndian32(entry + idLength));
+	const uint32_t secondParent(ReadBigEndian32(entry + idLength + 4));
+	std::string parentId;
+	if (firstParent != noParent)
+	{
+		if (!GetId(firstParent, parentId))
+			return false;
+		parents.push_back(parentId);
+	}
+
+	if ((secondParent & extraEdgesFlag) != 0)
+	{
+		size_t edge(secondParent & ~extraEdgesFlag);
+		uint32_t value;
+		do
+		{
+			if (edge >= layer->extraEdgeCount)
+				return false;
+
+			value = ReadBigEndian32(layer->extraEdges + 4 * edge++);
+			if (!GetId(value & ~extraEdgesFlag, parentId))
+				return false;
+			parents.push_back(parentId);
+		} while ((value & extraEdgesFlag) == 0);
+	}
+	else if (secondParent != noParent)
+	{
+		if (!GetId(secondParent, parentId))
+			return false;
+		parents.push_back(parentId);
+	}
+
+	const uint32_t generationAndTime(ReadBigEndian32(entry + idLength + 8));
+	generation = generationAndTime >> 2;
+	commitTime = (static_cast<int64_t>(generationAndTime & 0x3) << 32) |
+		ReadBigEndian32(entry + idLength + 12);
+	return true;
+}
+
+void CommitGraph::Load()
+{
+	loaded = true;
+
+	// A single file takes precedence over a chain, as it does for git
+	std::vector<std::string> fileNames;
+	const std::string graphDirectory(objectDirectory + "info/");
+	std::ifstream chain((graphDirectory + "commit-graphs/commit-graph-chain").c_str());
+	std::ifstream single((graphDirectory + "commit-graph").c_str());
+	if (single.is_open())
+		fileNames.push_back(graphDirectory + "commit-graph");
+	else
+	{
+		std::string hash;
+		while (std::getline(chain, hash))
+		{
+			if (!hash.empty())
+				fileNames.push_back(graphDirectory + "commit-graphs/graph-" + hash + ".graph");
+		}
+	}
+
+	// Each layer only refers to commits in the layers below it, so a layer
+	// that can't be used makes the ones above it unusable too
+	unsigned int i;
+	for (i = 0; i < fileNames.size(); i++)
+	{
+		Layer layer;
+		layer.firstPosition = layers.empty() ? 0 :
+			layers.back().firstPosition + layers.back().commitCount;
+		if (!LoadLayer(fileNames[i], layer))
+			break;
+		layers.push_back(layer);
+	}
+}
+
+bool CommitGraph::LoadLayer(const std::string& fileName, Layer& layer) const
+{
+	layer.data = ObjectStore::MapFile(fileName, layer.size);
+	if (!layer.data)
+		return false;
+
+	// Header:  signature, version, hash version, chunk count, base graph
+	// count, then a table of chunk IDs and offsets ending with a zero ID
+	const size_t headerSize(8);
+	const size_t chunkEntrySize(12);
+	const unsigned char* data(layer.data);
+	if (layer.size < headerSize + chunkEntrySize + idLength ||
+		memcmp(data, "CGPH", 4) != 0 || data[4] != 1 || data[5] != 1 ||
+		data[7] != layers.size())
+	{
+		ObjectStore::UnmapFile(layer.data, layer.size);
+		return false;
+	}
+
+	const unsigned int chunkCount(data[6]);
+	const size_t end(layer.size - idLength);// Trailing checksum
+	if (headerSize + (chunkCount + 1) * chunkEntrySize > end)
+	{
+		ObjectStore::UnmapFile(layer.data, layer.size);
+		return false;
+	}
+
+	layer.fanOut = NULL;
+	layer.ids = NULL;
+	layer.commitData = NULL;
+	layer.extraEdges = NULL;
+	layer.extraEdgeCount = 0;
+	size_t extraEdgesSize(0);
+	unsigned int i;
+	for (i = 0; i < chunkCount; i++)
+	{
+		const unsigned char* chunk(data + headerSize + i * chunkEntrySize);
+		const uint64_t offset((static_cast<uint64_t>(ReadBigEndian32(chunk + 4)) << 32) |
+			ReadBigEndian32(chunk + 8));
+		const uint64_t nextOffset((static_cast<uint64_t>(ReadBigEndian32(chunk + 16)) << 32) |
+			ReadBigEndian32(chunk + 20));
+		if (offset > nextOffset || nextOffset > end)
+		{
+			ObjectStore::UnmapFile(layer.data, layer.size);
+			return false;
+		}
+
+		if (memcmp(chunk, "OIDF", 4) == 0 && nextOffset - offset == 256 * 4)
+			layer.fanOut = data + offset;
+		else if (memcmp(chunk, "OIDL", 4) == 0)
+			layer.ids = data + offset;
+		else if (memcmp(chunk, "CDAT", 4) == 0)
+			layer.commitData = data + offset;
+		else if (memcmp(chunk, "EDGE", 4) == 0)
+		{
+			layer.extraEdges = data + offset;
+			extraEdgesSize = nextOffset - offset;
+		}
+	}
+
+	if (!layer.fanOut || !layer.ids || !layer.commitData)
+	{
+		ObjectStore::UnmapFile(layer.data, layer.size);
+		return false;
+	}
+
+	layer.commitCount = ReadBigEndian32(layer.fanOut + 255 * 4);
+	layer.extraEdgeCount = extraEdgesSize / 4;
+	if (layer.ids + static_cast<uint64_t>(layer.commitCount) * idLength > data + end ||
+		layer.commitData + static_cast<uint64_t>(layer.commitCount) * commitDataSize > data + end)
+	{
+		ObjectStore::UnmapFile(layer.data, layer.size);
+		return false;
+	}
+
+	// Old versions of git wrote zero for every generation number
+	if (layer.commitCount > 0 && ReadBigEndian32(layer.commitData + idLength + 8) >> 2 == 0)
+	{
+		ObjectStore::UnmapFile(layer.data, layer.size);
+		return false;
+	}
+
+	return true;
+}
+
+bool CommitGraph::FindPosition(const std::string& commitId, uint32_t& position) const
+{
+	if (commitId.length() != idLength)
+		return false;
+
+	const unsigned char first(static_cast<unsigned char>(commitId[0]));
+	unsigned int i;
+	for (i = 0; i < layers.size(); i++)
+	{
+		const Layer& layer(layers[i]);
+		uint32_t low(first == 0 ? 0 : ReadBigEndian32(layer.fanOut + 4 * (first - 1)));
+		uint32_t high(ReadBigEndian32(layer.fanOut + 4 * first));
+		if (high > layer.commitCount)
+			continue;
+
+		while (low < high)
+		{
+			const uint32_t middle(low + (high - low) / 2);
+			const int comparison(memcmp(layer.ids + middle * idLength,
+				commitId.data(), idLength));
+			if (comparison < 0)
+				low = middle + 1;
+			else if (comparison > 0)
+				high = middle;
+			else
+			{
+				position = layer.firstPosition + middle;
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+const CommitGraph::Layer* CommitGraph::FindLayer(const uint32_t& position) const
+{
+	unsigned int i;
+	for (i = 0; i < layers.size(); i++)
+	{
+		if (position < layers[i].firstPosition + layers[i].commitCount)
+			return &layers[i];
+	}
+
+	return NULL;
+}
+
+bool CommitGraph::GetId(const uint32_t& position, std::string& commitId) const
+{
+	const Layer* layer(FindLayer(position));
+	if (!layer)
+		return false;
+
+	commitId.assign(reinterpret_cast<const char*>(layer->ids +
+		(position - layer->firstPosition) * idLength), idLength);
+	return true;
+}
+
+uint32_t CommitGraph::ReadBigEndian32(const unsigned char* p)
+{
+	return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+		(static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+}
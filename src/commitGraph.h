@@ -0,0 +1,63 @@
+// File:  commitGraph.h
+// Date:  10/18/2026
+// Auth:  agent
+// Desc:  Reads parents, commit times and generation numbers from a
+//        repository's commit-graph file (or split commit-graph chain).
+
+#ifndef COMMIT_GRAPH_H_
+#define COMMIT_GRAPH_H_
+
+// Standard C++ headers
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+class CommitGraph
+{
+public:
+	// Accepts the common git directory; the files are read on first use
+	explicit CommitGraph(const std::string& commonDirectory);
+	~CommitGraph();
+
+	// Each commit's generation is greater than its parents'; commits that
+	// aren't in the graph are given this one
+	static const uint32_t noGeneration;
+
+	// Object IDs are raw bytes; false if the commit isn't in the graph
+	bool Lookup(const std::string& commitId, std::vector<std::string>& parents,
+		int64_t& commitTime, uint32_t& generation);
+
+private:
+	const std::string objectDirectory;
+	bool loaded;
+
+	struct Layer
+	{
+		const unsigned char* data;
+		size_t size;
+		uint32_t firstPosition;// Positions are numbered across the whole chain
+		uint32_t commitCount;
+		const unsigned char* fanOut;
+		const unsigned char* ids;
+		const unsigned char* commitData;
+		const unsigned char* extraEdges;
+		size_t extraEdgeCount;
+	};
+
+	std::vector<Layer> layers;
+
+	void Load();
+	bool LoadLayer(const std::string& fileName, Layer& layer) const;
+
+	bool FindPosition(const std::string& commitId, uint32_t& position) const;
+	const Layer* FindLayer(const uint32_t& position) const;
+	bool GetId(const uint32_t& position, std::string& commitId) const;
+
+	static uint32_t ReadBigEndian32(const unsigned char* p);
+
+	CommitGraph(const CommitGraph&);
+	CommitGraph& operator=(const CommitGraph&);
+};
+
+#endif// COMMIT_GRAPH_H_
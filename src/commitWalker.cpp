@@ -0,0 +1,257 @@
+// File:  commitWalker.cpp
+// Date:  10/18/2026
+// Auth:  agent
+// Desc:  Counts commits ahead of and behind a merge base.
+
+// Standard C/C++ headers
+#include <cstdlib>
+#include <fstream>
+#include <algorithm>
+#include <iterator>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+// Windows headers
+#include "windirent.h"// Local, but 3rd party
+#else
+#include <dirent.h>
+#endif
+
+// Local headers
+#include "commitWalker.h"
+
+CommitWalker::CommitWalker(const std::string& commonDirectory,
+	const size_t& cacheCapacity) : cacheCapacity(cacheCapacity),
+	historyRewritten(IsHistoryRewritten(commonDirectory)), objects(commonDirectory),
+	graph(commonDirectory)
+{
+}
+
+bool CommitWalker::CountAheadBehind(const std::string& local,
+	const std::string& remote, unsigned int& ahead, unsigned int& behind)
+{
+	if (historyRewritten)
+		return false;
+
+	// Commits are visited newest first, marking each parent with the sides
+	// it can be reached from; once only commits reachable from both sides
+	// remain, everything unique to either side has been seen
+	const unsigned char left(1), right(2), both(left | right), visited(4);
+	std::unordered_map<std::string, unsigned char> flags;
+
+	// Heap ordered by generation, commit time, then the order commits were
+	// queued.  Every descendant of a commit in the commit-graph has a higher
+	// generation, so by the time it's visited its sides are final.
+	struct QueueEntry
+	{
+		uint32_t generation;
+		int64_t commitTime;
+		int64_t order;
+		std::string id;
+
+		bool operator<(const QueueEntry& other) const
+		{
+			if (generation != other.generation)
+				return generation < other.generation;
+			else if (commitTime != other.commitTime)
+				return commitTime < other.commitTime;
+			return order > other.order;
+		}
+	};
+
+	std::vector<QueueEntry> queue;
+	int64_t queuedCount(0);
+	unsigned int nonStaleCount(0);// Queued commits not yet reached from both sides
+	auto mark = [&](const std::string& id, const unsigned char& flag)
+	{
+		// A side reaching commits that were already visited is passed on to
+		// their ancestors straight away, as they won't be visited again
+		std::vector<std::string> pending(1, id);
+		while (!pending.empty())
+		{
+			const std::string current(pending.back());
+			pending.pop_back();
+
+			unsigned char& existing(flags[current]);
+			if ((existing & flag) == flag)
+				continue;
+
+			const bool isNew(existing == 0);
+			const bool wasStale((existing & both) == both);
+			existing |= flag;
+			const Commit* commit(GetCommit(current));
+			if (!commit)
+				return false;
+			else if (isNew)
+			{
+				const QueueEntry entry = { commit->generation, commit->commitTime,
+					queuedCount++, current };
+				queue.push_back(entry);
+				std::push_heap(queue.begin(), queue.end());
+				if ((existing & both) != both)
+					nonStaleCount++;
+			}
+			else if ((existing & visited) != 0)
+				pending.insert(pending.end(), commit->parents.begin(), commit->parents.end());
+			else if (!wasStale && (existing & both) == both)
+				nonStaleCount--;
+		}
+
+		return true;
+	};
+
+	if (!mark(local, left) || !mark(remote, right))
+		return false;
+
+	// Commits outside the graph are only ordered by time, so keep going
+	// while shared ones remain that are no older than the last commit unique
+	// to one side, and for a while after that, in case a clock was wrong
+	// when one of them was made (git allows five commits of slop, but also
+	// has its merge bases to go on)
+	const unsigned int slopLimit(20);
+	unsigned int slop(slopLimit);
+	int64_t lastUniqueTime(INT64_MAX);
+	while (!queue.empty())
+	{
+		const bool inGraph(queue.front().generation != CommitGraph::noGeneration);
+		if (nonStaleCount > 0 || (!inGraph && queue.front().commitTime >= lastUniqueTime))
+			slop = slopLimit;
+		else if (inGraph || --slop == 0)
+			break;
+
+		std::pop_heap(queue.begin(), queue.end());
+		const std::string id(queue.back().id);
+		const int64_t commitTime(queue.back().commitTime);
+		queue.pop_back();
+
+		unsigned char& flag(flags[id]);
+		flag |= visited;
+		const unsigned char sides(flag & both);
+		if (sides != both)
+		{
+			nonStaleCount--;
+			lastUniqueTime = commitTime;
+		}
+
+		const std::vector<std::string> parents(GetCommit(id)->parents);
+		unsigned int i;
+		for (i = 0; i < parents.size(); i++)
+		{
+			if (!mark(parents[i], sides))
+				return false;
+		}
+	}
+
+	ahead = 0;
+	behind = 0;
+	std::unordered_map<std::string, unsigned char>::const_iterator it;
+	for (it = flags.begin(); it != flags.end(); ++it)
+	{
+		if ((it->second & both) == left)
+			ahead++;
+		else if ((it->second & both) == right)
+			behind++;
+	}
+
+	return true;
+}
+
+const CommitWalker::Commit* CommitWalker::GetCommit(const std::string& id)
+{
+	std::unordered_map<std::string, CommitList::iterator>::iterator it(commitLookup.find(id));
+	if (it != commitLookup.end())
+	{
+		recentCommits.splice(recentCommits.end(), recentCommits, it->second);
+		return &it->second->second;
+	}
+
+	Commit commit;
+	if (!graph.Lookup(id, commit.parents, commit.commitTime, commit.generation))
+	{
+		ObjectStore::Type type;
+		std::string contents;
+		commit.parents.clear();
+		commit.generation = CommitGraph::noGeneration;
+		if (!objects.Read(id, type, contents) || type != ObjectStore::TypeCommit ||
+			!ParseCommit(contents, commit))
+			return NULL;
+	}
+
+	if (recentCommits.size() >= cacheCapacity)
+	{
+		commitLookup.erase(recentCommits.front().first);
+		recentCommits.pop_front();
+	}
+
+	recentCommits.push_back(std::make_pair(id, commit));
+	commitLookup[id] = std::prev(recentCommits.end());
+	return &recentCommits.back().second;
+}
+
+bool CommitWalker::ParseCommit(const std::string& contents, Commit& commit)
+{
+	// Headers end at the first blank line; only the parents and the time
+	// from the committer line are needed
+	const std::string parentPrefix("parent ");
+	const std::string committerPrefix("committer ");
+	bool foundCommitter(false);
+	size_t start(0);
+	while (start < contents.length() && contents[start] != '\n')
+	{
+		size_t end(contents.find('\n', start));
+		if (end == std::string::npos)
+			end = contents.length();
+
+		if (contents.compare(start, parentPrefix.length(), parentPrefix) == 0)
+		{
+			const std::string parent(ObjectStore::FromHex(contents.substr(
+				start + parentPrefix.length(), end - start - parentPrefix.length())));
+			if (parent.empty())
+				return false;
+			commit.parents.push_back(parent);
+		}
+		else if (contents.compare(start, committerPrefix.length(), committerPrefix) == 0)
+		{
+			// "committer <name> <<email>> <time> <zone>"
+			const size_t emailEnd(contents.rfind('>', end));
+			if (emailEnd == std::string::npos || emailEnd < start)
+				return false;
+
+			commit.commitTime = strtoll(contents.c_str() + emailEnd + 1, NULL, 10);
+			foundCommitter = true;
+		}
+
+		start = end + 1;
+	}
+
+	return foundCommitter;
+}
+
+bool CommitWalker::IsHistoryRewritten(const std::string& commonDirectory)
+{
+	struct stat info;
+	if (stat((commonDirectory + "shallow").c_str(), &info) == 0 ||
+		stat((commonDirectory + "info/grafts").c_str(), &info) == 0)
+		return true;
+
+	DIR *dp(opendir((commonDirectory + "refs/replace").c_str()));
+	if (dp)
+	{
+		unsigned int count(0);
+		while (readdir(dp) != NULL)
+			count++;
+		closedir(dp);
+		if (count > 2)// More than . and ..
+			return true;
+	}
+
+	std::ifstream packedRefs((commonDirectory + "packed-refs").c_str());
+	std::string line;
+	while (std::getline(packedRefs, line))
+	{
+		if (line.find(" refs/replace/") != std::string::npos)
+			return true;
+	}
+
+	return false;
+}
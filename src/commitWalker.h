@@ -0,0 +1,58 @@
+// File:  commitWalker.h
+// Date:  10/18/2026
+// Auth:  agent
+// Desc:  Counts the commits on either side of two branches' merge base by
+//        walking parents read directly from the commit-graph and object
+//        database.
+
+#ifndef COMMIT_WALKER_H_
+#define COMMIT_WALKER_H_
+
+// Standard C++ headers
+#include <string>
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <cstdint>
+
+// Local headers
+#include "objectStore.h"
+#include "commitGraph.h"
+
+class CommitWalker
+{
+public:
+	// Accepts the common git directory; decoded commits are kept for reuse by
+	// later comparisons in the same repository
+	explicit CommitWalker(const std::string& commonDirectory,
+		const size_t& cacheCapacity = 16384);
+
+	// Same as git rev-list --left-right --count local...remote (object IDs
+	// are raw bytes); false if the history can't be read without git
+	bool CountAheadBehind(const std::string& local, const std::string& remote,
+		unsigned int& ahead, unsigned int& behind);
+
+private:
+	const size_t cacheCapacity;
+	const bool historyRewritten;// Shallow clones, grafts and replacement objects
+	ObjectStore objects;
+	CommitGraph graph;
+
+	struct Commit
+	{
+		std::vector<std::string> parents;
+		int64_t commitTime;
+		uint32_t generation;
+	};
+
+	// Least recently used first
+	typedef std::list<std::pair<std::string, Commit> > CommitList;
+	CommitList recentCommits;
+	std::unordered_map<std::string, CommitList::iterator> commitLookup;
+
+	const Commit* GetCommit(const std::string& id);
+	static bool ParseCommit(const std::string& contents, Commit& commit);
+	static bool IsHistoryRewritten(const std::string& commonDirectory);
+};
+
+#endif// COMMIT_WALKER_H_
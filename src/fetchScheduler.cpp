@@ -0,0 +1,103 @@
+// File:  fetchScheduler.cpp
+// Date:  10/18/2026
+// Auth:  agent
+// Desc:  Limits simultaneous fetches overall and per host.
+
+// Standard C++ headers
+#include <cctype>
+#include <cassert>
+
+// Local headers
+#include "fetchScheduler.h"
+
+FetchScheduler::FetchScheduler(const unsigned int& globalLimit,
+	const unsigned int& perHostLimit) : globalLimit(globalLimit),
+	perHostLimit(perHostLimit)
+{
+	activeCount = 0;
+}
+
+FetchScheduler::Slot::Slot(FetchScheduler& scheduler, const std::string& url)
+	: scheduler(scheduler), host(GetHost(url))
+{
+	scheduler.Acquire(host);
+}
+
+FetchScheduler::Slot::~Slot()
+{
+	scheduler.Release(host);
+}
+
+void FetchScheduler::Acquire(const std::string& host)
+{
+	std::unique_lock<std::mutex> lock(mutex);
+
+	// Local repositories don't use a network connection, so only the
+	// global limit applies to them
+	while ((globalLimit > 0 && activeCount >= globalLimit) ||
+		(perHostLimit > 0 && !host.empty() && activeByHost[host] >= perHostLimit))
+		released.wait(lock);
+
+	activeCount++;
+	activeByHost[host]++;
+}
+
+void FetchScheduler::Release(const std::string& host)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		assert(activeCount > 0 && activeByHost[host] > 0);
+		activeCount--;
+		if (--activeByHost[host] == 0)
+			activeByHost.erase(host);
+	}
+
+	// Waiters may be blocked on different hosts, so wake all of them
+	released.notify_all();
+}
+
+std::string FetchScheduler::GetHost(const std::string& url)
+{
+	std::string host;
+	const std::string schemeSeparator("://");
+	const size_t schemeEnd(url.find(schemeSeparator));
+	if (schemeEnd != std::string::npos)
+	{
+		// scheme://[user@]host[:port]/path
+		if (url.compare(0, schemeEnd, "file") == 0)
+			return "";
+
+		const size_t start(schemeEnd + schemeSeparator.length());
+		host = url.substr(start, url.find('/', start) - start);
+	}
+	else
+	{
+		// scp-like syntax:  [user@]host:path (a slash before the colon
+		// means this is a local path)
+		const size_t colon(url.find(':'));
+		if (colon == std::string::npos || url.find('/') < colon)
+			return "";
+
+		// Windows drive letters
+		if (colon == 1)
+			return "";
+
+		host = url.substr(0, colon);
+	}
+
+	const size_t at(host.find_last_of('@'));
+	if (at != std::string::npos)
+		host.erase(0, at + 1);
+
+	// Strip the port, taking care with bracketed IPv6 addresses
+	if (!host.empty() && host[0] == '[')
+		host = host.substr(1, host.find(']') - 1);
+	else if (host.find(':') != std::string::npos)
+		host.erase(host.find(':'));
+
+	unsigned int i;
+	for (i = 0; i < host.length(); i++)
+		host[i] = static_cast<char>(std::tolower(static_cast<unsigned char>(host[i])));
+
+	return host;
+}
@@ -0,0 +1,55 @@
+// File:  fetchScheduler.h
+// Date:  10/18/2026
+// Auth:  agent
+// Desc:  Limits the number of simultaneous fetches, both overall and for
+//        each remote host.
+
+#ifndef FETCH_SCHEDULER_H_
+#define FETCH_SCHEDULER_H_
+
+// Standard C++ headers
+#include <string>
+#include <map>
+#include <mutex>
+#include <condition_variable>
+
+class FetchScheduler
+{
+public:
+	// Zero means unlimited
+	FetchScheduler(const unsigned int& globalLimit,
+		const unsigned int& perHostLimit);
+
+	// Holds a connection slot for the lifetime of the object
+	class Slot
+	{
+	public:
+		Slot(FetchScheduler& scheduler, const std::string& url);
+		~Slot();
+
+	private:
+		FetchScheduler& scheduler;
+		const std::string host;
+
+		Slot(const Slot&);
+		Slot& operator=(const Slot&);
+	};
+
+	// Returns the host name portion of a remote URL, or an empty string for
+	// local repositories
+	static std::string GetHost(const std::string& url);
+
+private:
+	const unsigned int globalLimit;
+	const unsigned int perHostLimit;
+
+	std::mutex mutex;
+	std::condition_variable released;
+	unsigned int activeCount;
+	std::map<std::string, unsigned int> activeByHost;
+
+	void Acquire(const std::string& host);
+	void Release(const std::string& host);
+};
+
+#endif// FETCH_SCHEDULER_H_
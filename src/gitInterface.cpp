@@ -6,12 +6,23 @@
 // Standard C/C++ headers
 #include <sstream>
 #include <iostream>
-#include <cassert>
 #include <cstdlib>
+#include <fstream>
+#include <algorithm>
+#include <future>
+#include <sys/stat.h>
 
 // Local headers
 #include "gitInterface.h"
 #include "shellInterface.h"
+#include "refStore.h"
+#include "statusCache.h"
+#include "indexFile.h"
+#include "workTreeScanner.h"
+#include "objectStore.h"
+#include "commitWalker.h"
+#include "jobLimiter.h"
+#include "performanceStats.h"
 #include "stringUtilities.h"
 
 #ifdef _WIN32
@@ -22,23 +33,29 @@ const std::string GitInterface::gitName("git");
 const std::string GitInterface::gitDirectoryArgument("--git-dir=");
 const std::string GitInterface::gitWorkTreeArgument("--work-tree=");
 const std::string GitInterface::gitGetVersionCmd("version");
-const std::string GitInterface::gitGetUntrackedFilesCmd("ls-files --other --error-unmatch --exclude-standard");
-const std::string GitInterface::gitGetUnstagedChangesCmd("diff --shortstat");
-const std::string GitInterface::gitGetUncommittedChangesCmd("diff --cached --quiet HEAD");
-const std::string GitInterface::gitListBranchesCmd("branch");
-const std::string GitInterface::gitListRemoteBranchesCmd("branch -r");
-const std::string GitInterface::gitGetCurrentBranchCmd("rev-parse --abbrev-ref HEAD");
-const std::string GitInterface::gitListRemotesCmd("remote");
-const std::string GitInterface::gitFetchAllCmd("fetch --all --prune --tags");
-const std::string GitInterface::gitPushCmd("push --tags");
+const std::string GitInterface::gitStatusCmd("status --porcelain=v2 --branch --ignore-submodules=dirty");
+const std::string GitInterface::gitNoUntrackedArgument("-uno");
+const std::string GitInterface::gitDiffCachedCmd("diff-index --cached --quiet --ita-invisible-in-index --ignore-submodules=dirty HEAD");
+const std::string GitInterface::gitListRefsCmd("for-each-ref");
+const std::string GitInterface::gitListRefsFormat("--format=%(objectname) %(refname) %(symref)");
+const std::string GitInterface::gitListRemotesCmd("remote -v");
+const std::string GitInterface::gitFetchCmd("fetch --prune --tags");
+const std::string GitInterface::gitListRemoteRefsCmd("ls-remote --heads --tags");
+const std::string GitInterface::gitPushCmd("push --porcelain --tags");
+const std::string GitInterface::gitAtomicArgument("--atomic");
+const std::string GitInterface::gitCountAheadBehindCmd("rev-list --left-right --count");
 //const std::string GitInterface::gitPushCmd("push --follow-tags");// git 1.8.3 or later only
-const std::string GitInterface::gitFailMessage("fatal:");
+
+GitInterface::GitInterface(const Options& options) : options(options),
+	fetchScheduler(options.fetchJobs, options.fetchJobsPerHost)
+{
+}
 
 std::string GitInterface::GetGitVersion()
 {
 	ShellInterface shell;
 	std::string version;
-	if (!shell.ExecuteCommand(gitName + " " + gitGetVersionCmd, version))
+	if (!shell.ExecuteCommand(SplitArguments(gitName + " " + gitGetVersionCmd), version))
 		return "";
 	return version;
 }
@@ -61,221 +78,595 @@ std::string GitInterface::ExtractLastDirectory(const std::string& path)
 }
 
 GitInterface::RepositoryInfo GitInterface::GetRepositoryInfo(
-	const std::string& path)
+	const std::string& path) const
 {
 	RepositoryInfo info;
 	info.name = ExtractLastDirectory(path);
+	info.path = path;
+	if (options.repositoryTimeout > 0.0)
+		info.deadline = std::chrono::steady_clock::now() +
+			std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+			std::chrono::duration<double>(options.repositoryTimeout));
+	if (!ReadState(path, info))
+		return info;
+
+	// Each submodule is checked as a repository of its own (the superproject's
+	// status only reports new commits in submodules, not their working trees)
+	const std::vector<std::string> subModulePaths(FindSubModules(path));
+	info.subModules.resize(subModulePaths.size());
+	auto checkSubModule = [&](const unsigned int& i)
+	{
+		info.subModules[i] = GetRepositoryInfo(path + subModulePaths[i] + "/");
+		info.subModules[i].name = info.name + "/" + subModulePaths[i];
+	};
+
+	if (options.jobLimiter)
+		options.jobLimiter->ForEach(subModulePaths.size(), checkSubModule);
+	else
+	{
+		unsigned int i;
+		for (i = 0; i < subModulePaths.size(); i++)
+			checkSubModule(i);
+	}
+
+	return info;
+}
+
+bool GitInterface::ReadState(const std::string& path, RepositoryInfo& info) const
+{
+	PerformanceStats::PhaseTimer timer(PerformanceStats::PhaseStatus);
+
+	// Without counts or untracked files, the working tree can usually be
+	// checked against the index's stat data without running git status
+	if (!(options.untrackedMode == UntrackedNo && !options.countChanges &&
+		ReadNativeStatus(path, info)) && !ReadStatus(path, info))
+		return false;
 
+	// Edits to the working tree don't touch .git, so the status above always
+	// runs, but the remotes and refs can be reused if nothing in .git changed
+	const uint64_t fingerprint(options.cache ?
+		StatusCache::ComputeFingerprint(path) : 0);
+	RepositoryInfo cached;
+	if (options.cache && options.cache->Lookup(path, fingerprint, cached))
+	{
+		info.branches = cached.branches;
+		info.tags = cached.tags;
+		info.remotes = cached.remotes;
+	}
+	else
+	{
+		ShellInterface shell;
+		shell.SetDeadline(GetDeadline(info));
+		std::string stdOut;
+		if (!shell.ExecuteCommand(BuildCommand(path, gitListRemotesCmd), stdOut))
+			std::cerr << "Failed to list remotes" << std::endl;
+		info.remotes = ParseRemotes(stdOut);
+		ReadRefs(path, info);
+
+		if (options.cache)
+			options.cache->Store(path, fingerprint, info);
+	}
+
+	std::string gitDirectory, commonDirectory;
+	if (!info.remotes.empty() &&
+		RefStore::FindGitDirectory(path, gitDirectory, commonDirectory))
+		info.history = std::make_shared<CommitWalker>(commonDirectory);
+
+	return true;
+}
+
+bool GitInterface::ReadStatus(const std::string& path, RepositoryInfo& info) const
+{
+	// One pass over the index and working tree answers all three questions
+	ShellInterface::ArgumentList statusArguments;
+	if (options.untrackedMode == UntrackedNo)
+		statusArguments.push_back(gitNoUntrackedArgument);
+
+	// Lines are parsed as they arrive so large untracked lists are never held
+	// in memory.  By the time git prints anything it has finished refreshing
+	// the index, so stopping it early can't leave a stale index.lock behind.
 	ShellInterface shell;
-	shell.ExecuteCommand(BuildCommand(path, gitGetUncommittedChangesCmd));
-	if (shell.GetExitCode() == 129)
+	shell.SetDeadline(GetDeadline(info));
+	ShellInterface::ProcessResult status;
+	const UntrackedMode untrackedMode(options.untrackedMode);
+	const bool countChanges(options.countChanges);
+	if (!shell.ExecuteCommand(BuildCommand(path, gitStatusCmd, statusArguments),
+		[&info, untrackedMode, countChanges](const std::string& line)
+		{
+			return !ParseStatusLine(line, info, untrackedMode) || countChanges;
+		}, status))
+		std::cerr << "Failed to check repository status" << std::endl;
+
+	info.timedOut = status.timedOut;
+	info.isGitRepository = status.started && !status.timedOut &&
+		(status.exitCode == 0 || status.stoppedEarly);
+	if (!info.isGitRepository)
+		return false;
+
+	info.uncommittedChanges = info.uncommittedCount > 0;
+	info.unstagedChanges = info.unstagedCount > 0;
+	info.untrackedFiles = info.untrackedCount > 0;
+	info.exactCounts = !status.stoppedEarly;
+
+	return true;
+}
+
+bool GitInterface::ReadNativeStatus(const std::string& path, RepositoryInfo& info) const
+{
+	WorkTreeScanner scanner(options.jobLimiter);
+	const WorkTreeScanner::Result result(scanner.FindUnstagedChange(path));
+	if (result == WorkTreeScanner::ResultUnknown)
+		return false;
+
+	// Staged changes only need the index and HEAD's tree; git is only asked
+	// when the index's cache-tree has been invalidated (or HEAD is packed)
+	bool staged(scanner.HasConflicts());
+	const WorkTreeScanner::Result stagedResult(staged ?
+		WorkTreeScanner::ResultModified : scanner.FindStagedChange(path));
+	if (stagedResult != WorkTreeScanner::ResultUnknown)
+		staged = stagedResult == WorkTreeScanner::ResultModified;
+	else
 	{
-		info.isGitRepository = false;
-		return info;
+		ShellInterface shell;
+		shell.SetDeadline(GetDeadline(info));
+		ShellInterface::ProcessResult diff;
+		shell.ExecuteCommand(BuildCommand(path, gitDiffCachedCmd), diff,
+			ShellInterface::RedirectAllToNull);
+		if (diff.timedOut || !diff.started || diff.exitCode > 1)
+			return false;// Including an unborn branch
+		staged = diff.exitCode == 1;
 	}
+
+	std::string gitDirectory, commonDirectory, head;
+	if (!RefStore::FindGitDirectory(path, gitDirectory, commonDirectory) ||
+		!std::getline(std::ifstream((gitDirectory + "HEAD").c_str()), head))
+		return false;
+
+	const std::string branchPrefix("ref: refs/heads/");
+	if (head.compare(0, branchPrefix.length(), branchPrefix) == 0)
+		info.currentBranch = head.substr(branchPrefix.length());
 	else
-		info.isGitRepository = true;
-	info.uncommittedChanges = shell.GetExitCode() != 0;
+		info.currentBranch = "(detached)";
 
-	std::string stdOut;
-	if (!shell.ExecuteCommand(BuildCommand(path, gitGetUnstagedChangesCmd),
-		stdOut, ShellInterface::RedirectErrToOut))
-		std::cerr << "Failed to check for unstaged changes" << std::endl;
-	info.unstagedChanges = !stdOut.empty();
-
-	if (!shell.ExecuteCommand(BuildCommand(path, gitGetUntrackedFilesCmd),
-		stdOut, ShellInterface::RedirectErrToOut))
-		std::cerr << "Failed to check for untracked files" << std::endl;
-	info.untrackedFiles = !stdOut.empty();
-
-	if (!shell.ExecuteCommand(BuildCommand(path, gitListRemotesCmd), stdOut,
-		ShellInterface::RedirectErrToOut))
-		std::cerr << "Failed to list remotes" << std::endl;
-	info.remotes = BuildRemotes(path, SplitBufferByLine(stdOut));
-
-	if (!shell.ExecuteCommand(BuildCommand(path, gitListBranchesCmd), stdOut,
-		ShellInterface::RedirectErrToOut))
-		std::cerr << "Failed to list branches" << std::endl;
-	info.branches = BuildBranches(path, SplitBufferByLine(stdOut));
-
-	// TODO:  Implement
-	//info.subModules;
-	// See:  http://stackoverflow.com/questions/1030169/easy-way-pull-latest-of-all-submodules
+	info.isGitRepository = true;
+	info.uncommittedChanges = staged;
+	info.unstagedChanges = result == WorkTreeScanner::ResultModified || scanner.HasConflicts();
+	info.uncommittedCount = info.uncommittedChanges ? 1 : 0;
+	info.unstagedCount = info.unstagedChanges ? 1 : 0;
+	info.exactCounts = !info.uncommittedChanges && !info.unstagedChanges;
 
-	return info;
+	return true;
 }
 
-std::vector<GitInterface::RemoteInfo> GitInterface::BuildRemotes(
-	const std::string& path, const std::vector<std::string>& remotes)
+ShellInterface::Deadline GitInterface::GetDeadline(const RepositoryInfo& info) const
 {
-	std::vector<RemoteInfo> info(remotes.size());
-	unsigned int i;
-	for (i = 0; i < remotes.size(); i++)
-		info[i] = BuildRemote(path, remotes[i]);
-	return info;
+	if (options.commandTimeout <= 0.0)
+		return info.deadline;
+
+	const ShellInterface::Deadline commandDeadline(std::chrono::steady_clock::now() +
+		std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+		std::chrono::duration<double>(options.commandTimeout)));
+	return std::min(commandDeadline, info.deadline);
 }
 
-GitInterface::RemoteInfo GitInterface::BuildRemote(const std::string& path,
-	const std::string& remote)
+std::vector<std::string> GitInterface::FindSubModules(const std::string& path)
 {
-	RemoteInfo info;
-	info.name = remote;
+	// Submodules may be listed in .gitmodules without having been added yet,
+	// or (rarely) added without a .gitmodules entry, so check both
+	std::vector<std::string> candidates;
+	std::ifstream gitModules((path + ".gitmodules").c_str());
+	std::string line;
+	while (std::getline(gitModules, line))
+	{
+		line = Trim(line);
+		const size_t equals(line.find('='));
+		if (equals != std::string::npos &&
+			Trim(line.substr(0, equals)).compare("path") == 0)
+			candidates.push_back(Trim(line.substr(equals + 1)));
+	}
 
-	ShellInterface shell;
-	std::string stdOut;
-	if (!shell.ExecuteCommand(BuildCommand(path, gitListRemoteBranchesCmd), stdOut))
-		std::cerr << "Failed to list remote branches" << std::endl;
-	std::vector<std::string> branches = SplitBufferByLine(stdOut);
+	std::string gitDirectory, commonDirectory;
+	IndexFile index;
+	if (RefStore::FindGitDirectory(path, gitDirectory, commonDirectory) &&
+		index.Read(gitDirectory + "index"))
+	{
+		const std::vector<IndexFile::Entry>& entries(index.GetEntries());
+		unsigned int i;
+		for (i = 0; i < entries.size(); i++)
+		{
+			if (entries[i].IsGitlink() && entries[i].GetStage() == 0)
+				candidates.push_back(entries[i].path);
+		}
+	}
+
+	std::sort(candidates.begin(), candidates.end());
+	candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+	// Only initialized submodules have anything to check
+	std::vector<std::string> subModules;
 	unsigned int i;
-	size_t slashLocation;
-	for (i = 0; i < branches.size(); i++)
+	for (i = 0; i < candidates.size(); i++)
 	{
-		slashLocation = branches[i].find('/');
-		assert(slashLocation != std::string::npos);
+		struct stat info;
+		if (!candidates[i].empty() &&
+			stat((path + candidates[i] + "/.git").c_str(), &info) == 0)
+			subModules.push_back(candidates[i]);
+	}
 
-		if (slashLocation < remote.length())
+	return subModules;
+}
+
+std::vector<GitInterface::RemoteInfo> GitInterface::ParseRemotes(
+	const std::string& remoteList)
+{
+	// Each line is "<name>\t<url> (fetch)" or "<name>\t<url> (push)"
+	std::vector<RemoteInfo> remotes;
+	std::istringstream ss(remoteList);
+	std::string line;
+	const std::string fetchSuffix(" (fetch)");
+	while (std::getline(ss, line))
+	{
+		const size_t tab(line.find('\t'));
+		if (tab == std::string::npos || line.length() < fetchSuffix.length() ||
+			line.compare(line.length() - fetchSuffix.length(),
+			fetchSuffix.length(), fetchSuffix) != 0)
 			continue;
-		else if (branches[i].substr(slashLocation - remote.length(), remote.length()).compare(remote) == 0)
-		{
-			// Hack to fix problems that can occur when a repo has an entry like "origin/HEAD -> origin/master"
-			slashLocation = branches[i].find_last_of('/');
-			assert(slashLocation != std::string::npos);
-			info.branches.push_back(BuildBranch(path, remote, branches[i].substr(slashLocation + 1)));
-		}
+
+		RemoteInfo remote;
+		remote.name = NameTable::Intern(line.substr(0, tab));
+		remote.url = line.substr(tab + 1,
+			line.length() - fetchSuffix.length() - tab - 1);
+		remotes.push_back(remote);
 	}
 
-	
-	//info.branches// TODO
+	return remotes;
+}
 
-	return info;
+bool GitInterface::ParseStatusLine(const std::string& line,
+	RepositoryInfo& info, const UntrackedMode& untrackedMode)
+{
+	const std::string branchHeader("# branch.head ");
+	if (line.empty())
+		return false;
+
+	// Changed entries are "<type> <XY> ..." where X is the staged state
+	// and Y is the working tree state ('.' means unmodified)
+	switch (line[0])
+	{
+	case '1':// Ordinary change
+	case '2':// Rename or copy
+	case 'u':// Unmerged
+		if (line.length() < 4)
+			return false;
+		if (line[2] != '.' || line[0] == 'u')
+			info.uncommittedCount++;
+		if (line[3] != '.' || line[0] == 'u')
+			info.unstagedCount++;
+		return untrackedMode == UntrackedNo && info.uncommittedCount > 0 &&
+			info.unstagedCount > 0;
+
+	case '?':
+		info.untrackedCount++;
+		return true;
+
+	case '#':
+		if (line.compare(0, branchHeader.length(), branchHeader) == 0)
+			info.currentBranch = line.substr(branchHeader.length());
+		return false;
+
+	default:
+		return false;
+	}
 }
 
-std::string GitInterface::CleanString(const std::string &name)
+void GitInterface::UpdateRefs(const std::string& path,
+	RepositoryInfo& info) const
 {
-	std::string cleanName(Trim(name));
-	assert(name.length() > 0);
-	if (name[0] == '*')
-		cleanName = Trim(cleanName.substr(1));
-	return cleanName;
+	PerformanceStats::PhaseTimer timer(PerformanceStats::PhaseFetch);
+
+	// Fingerprint first so a ref updated while we read isn't cached as current
+	const uint64_t fingerprint(options.cache ?
+		StatusCache::ComputeFingerprint(path) : 0);
+	ReadRefs(path, info);
+	if (options.cache)
+		options.cache->Store(path, fingerprint, info);
 }
 
-std::vector<GitInterface::BranchInfo> GitInterface::BuildBranches(
-	const std::string& path, const std::vector<std::string>& branches)
+void GitInterface::ReadRefs(const std::string& path, RepositoryInfo& info)
 {
-	std::vector<BranchInfo> info(branches.size());
-	unsigned int i;
-	for (i = 0; i < branches.size(); i++)
-		info[i] = BuildBranch(path, branches[i]);
-	return info;
+	// Let git list refs that are stored in ways we don't understand
+	RefStore refStore;
+	if (!refStore.Read(path) && !ReadRefSnapshot(path, refStore))
+		std::cerr << "Failed to list refs" << std::endl;
+	BuildRemoteBranches(refStore, info.remotes);
+	info.branches = BuildBranches(refStore);
+	info.tags = BuildTags(refStore);
 }
 
-GitInterface::BranchInfo GitInterface::BuildBranch(const std::string& path,
-	const std::string& branch)
+bool GitInterface::ReadRefSnapshot(const std::string& path, RefStore& refStore)
 {
-	BranchInfo info;
-	info.name = branch;
-	info.hash = GetLocalHead(path, CleanString(branch));
-	return info;
+	ShellInterface shell;
+	std::string stdOut;
+	if (!shell.ExecuteCommand(BuildCommand(path, gitListRefsCmd,
+		{ gitListRefsFormat, "refs/heads", "refs/remotes", "refs/tags" }), stdOut) ||
+		shell.GetExitCode() != 0)
+		return false;
+	return refStore.ReadSnapshot(stdOut);
+}
+
+void GitInterface::BuildRemoteBranches(const RefStore& refStore,
+	std::vector<RemoteInfo>& remotes)
+{
+	unsigned int i;
+	for (i = 0; i < remotes.size(); i++)
+		remotes[i].branches.clear();
+
+	// Remote names may contain slashes, so assign each remote-tracking ref to
+	// the longest remote name that matches.  Symbolic refs (like
+	// refs/remotes/origin/HEAD) are not branches and are not listed.
+	const std::string remotesPrefix("refs/remotes/");
+	const std::vector<std::string> refs(refStore.List(remotesPrefix));
+	unsigned int j;
+	for (j = 0; j < refs.size(); j++)
+	{
+		const std::string name(refs[j].substr(remotesPrefix.length()));
+		int bestMatch(-1);
+		for (i = 0; i < remotes.size(); i++)
+		{
+			const std::string& remoteName(remotes[i].name);
+			if (name.length() > remoteName.length() + 1 &&
+				name.compare(0, remoteName.length(), remoteName) == 0 &&
+				name[remoteName.length()] == '/' &&
+				(bestMatch < 0 || remoteName.length() > remotes[bestMatch].name.Get().length()))
+				bestMatch = i;
+		}
+
+		if (bestMatch < 0)
+			continue;
+
+		BranchInfo branch;
+		branch.name = NameTable::Intern(name.substr(remotes[bestMatch].name.Get().length() + 1));
+		branch.hash = ObjectId::FromHex(refStore.Resolve(refs[j]));
+		remotes[bestMatch].branches.push_back(branch);
+	}
 }
 
-GitInterface::BranchInfo GitInterface::BuildBranch(const std::string& path,
-	const std::string& remote, const std::string& branch)
+std::vector<GitInterface::BranchInfo> GitInterface::BuildBranches(
+	const RefStore& refStore)
 {
-	BranchInfo info;
-	info.name = branch;
-	info.hash = GetRemoteHead(path, remote, branch);
+	const std::string prefix("refs/heads/");
+	const std::vector<std::string> refs(refStore.List(prefix));
+	std::vector<BranchInfo> info(refs.size());
+	unsigned int i;
+	for (i = 0; i < refs.size(); i++)
+	{
+		info[i].name = NameTable::Intern(refs[i].substr(prefix.length()));
+		info[i].hash = ObjectId::FromHex(refStore.Resolve(refs[i]));
+	}
+
 	return info;
 }
 
-std::vector<std::string> GitInterface::SplitBufferByLine(const std::string& buffer)
+std::vector<GitInterface::TagInfo> GitInterface::BuildTags(const RefStore& refStore)
 {
-	std::vector<std::string> lines;
-	std::istringstream ss(buffer);
-	std::string token;
-	while (std::getline(ss, token))
-		lines.push_back(CleanString(token));
-	return lines;
+	const std::string prefix("refs/tags/");
+	const std::vector<std::string> refs(refStore.List(prefix));
+	std::vector<TagInfo> info(refs.size());
+	unsigned int i;
+	for (i = 0; i < refs.size(); i++)
+	{
+		info[i].name = refs[i].substr(prefix.length());
+		info[i].hash = ObjectId::FromHex(refStore.Resolve(refs[i]));
+	}
+
+	return info;
 }
 
-bool GitInterface::FetchAll(const std::string& path, std::string& errorString)
+GitInterface::FetchResult GitInterface::FetchAll(const std::string& path,
+	const RepositoryInfo& info, std::vector<FetchError>& errors)
 {
-	ShellInterface shell;
-	std::string stdOut;
+	PerformanceStats::PhaseTimer timer(PerformanceStats::PhaseFetch);
 
-	if (!shell.ExecuteCommand(BuildCommand(path, gitFetchAllCmd), stdOut,
-		ShellInterface::RedirectErrToOut))
+	// Every remote is fetched at once by the executor, rather than one after
+	// another.  Each fetch still holds a connection slot for its host, which
+	// is released when the last completion function referring to it is gone.
+	std::vector<std::future<FetchResult> > fetched;
+	unsigned int i;
+	for (i = 0; i < info.remotes.size(); i++)
 	{
-		std::cerr << "Failed to execute fetch command" << std::endl;
-		return false;
+		const RemoteInfo& remote(info.remotes[i]);
+		std::shared_ptr<FetchScheduler::Slot> slot(
+			new FetchScheduler::Slot(fetchScheduler, remote.url));
+		std::shared_ptr<std::promise<FetchResult> > promise(new std::promise<FetchResult>);
+		fetched.push_back(promise->get_future());
+
+		const ShellInterface::ArgumentList fetchCommand(BuildCommand(path,
+			gitFetchCmd, { remote.name }));
+		auto fetch = [this, &info, slot, promise, fetchCommand]()
+		{
+			if (!executor.Start(fetchCommand,
+				[slot, promise](const ShellInterface::ProcessResult& result)
+				{
+					promise->set_value(result.timedOut ? FetchTimedOut :
+						(result.started && result.exitCode == 0 ? FetchSucceeded : FetchFailed));
+				}, GetDeadline(info)))
+				promise->set_value(FetchFailed);
+		};
+
+		if (!options.conditionalFetch)
+		{
+			fetch();
+			continue;
+		}
+
+		// Asks the remote for its ref advertisement only, which is much
+		// cheaper than the negotiation performed by a full fetch
+		if (!executor.Start(BuildCommand(path, gitListRemoteRefsCmd, { remote.name }),
+			[&info, &remote, promise, fetch](const ShellInterface::ProcessResult& result)
+			{
+				if (result.timedOut)
+					promise->set_value(FetchTimedOut);
+				else if (result.started && result.exitCode == 0 &&
+					RemoteIsUnchanged(result.stdOut, info, remote))
+					promise->set_value(FetchSucceeded);
+				else
+					fetch();
+			}, GetDeadline(info)))
+			fetch();
 	}
 
-	std::istringstream ss(stdOut);
-	if (ss.str().length() == 0)
+	FetchResult overall(FetchSucceeded);
+	for (i = 0; i < fetched.size(); i++)
 	{
-		std::cerr << "No remotes to fetch" << std::endl;
-		return false;
+		const FetchResult result(fetched[i].get());
+		if (result == FetchSucceeded)
+			continue;
+
+		FetchError error;
+		error.remote = info.remotes[i].name.Get();
+		if (result == FetchTimedOut)
+		{
+			error.message = "timed out";
+			error.timedOut = true;
+			overall = FetchTimedOut;
+		}
+		else
+		{
+			error.message = "failed";
+			if (overall == FetchSucceeded)
+				overall = FetchFailed;
+		}
+		errors.push_back(error);
 	}
 
-	bool fetchedAll(true);
-	std::string response, remoteName;
-	const std::string fetching("Fetching");
-	while (std::getline(ss, response))
+	return overall;
+}
+
+bool GitInterface::RemoteIsUnchanged(const std::string& advertisedRefs,
+	const RepositoryInfo& info, const RemoteInfo& remote)
+{
+	const std::string headsPrefix("refs/heads/");
+	const std::string tagsPrefix("refs/tags/");
+	const std::string peeledSuffix("^{}");
+	unsigned int headCount(0);
+	std::istringstream ss(advertisedRefs);
+	std::string line;
+	while (std::getline(ss, line))
 	{
-		if (response.length() > fetching.length() &&
-			response.substr(0, fetching.length()).compare(fetching) == 0)
-			remoteName = Trim(response.substr(fetching.length()));
-		else if (response.length() > gitFailMessage.length() &&
-			response.substr(0, gitFailMessage.length()).compare(gitFailMessage) == 0)
+		// Each line is "<object>\t<ref>"
+		const size_t tab(line.find('\t'));
+		if (tab == std::string::npos)
+			return false;
+
+		const ObjectId hash(ObjectId::FromHex(line.substr(0, tab)));
+		const std::string ref(line.substr(tab + 1));
+		if (hash.IsNull())
+			return false;
+		if (ref.compare(0, headsPrefix.length(), headsPrefix) == 0)
+		{
+			if (FindHash(remote.branches, ref.substr(headsPrefix.length())) != hash)
+				return false;
+			headCount++;
+		}
+		else if (ref.compare(0, tagsPrefix.length(), tagsPrefix) == 0)
 		{
-			std::ostringstream errorStream;
-			errorStream << "  Failed to fetch from " << remoteName << "\n";
-			errorString.append(errorStream.str());
-			fetchedAll = false;
+			// Tags fetched from other remotes may exist locally too, so we only
+			// check that every tag on this remote is already here
+			if (ref.length() > peeledSuffix.length() &&
+				ref.compare(ref.length() - peeledSuffix.length(),
+				peeledSuffix.length(), peeledSuffix) == 0)
+				continue;
+
+			if (FindHash(info.tags, ref.substr(tagsPrefix.length())) != hash)
+				return false;
 		}
 	}
 
-	return fetchedAll;
+	// A branch deleted from the remote still needs to be pruned
+	return headCount == remote.branches.size();
 }
 
-bool GitInterface::PushToRemote(const std::string& path,
-	const std::string& remote, std::string& branch)
+std::vector<GitInterface::PushResult> GitInterface::PushToRemote(
+	const std::string& path, const RepositoryInfo& info, const std::string& remote,
+	const std::vector<std::string>& branches) const
 {
+	PerformanceStats::PhaseTimer timer(PerformanceStats::PhasePush);
+	std::vector<PushResult> results(branches.size());
+	if (branches.empty())
+		return results;
+
+	ShellInterface::ArgumentList arguments;
+	if (options.atomicPush)
+		arguments.push_back(gitAtomicArgument);
+	arguments.push_back(remote);
+	arguments.insert(arguments.end(), branches.begin(), branches.end());
+
+	// Exits with 1 if any ref was rejected, but the porcelain output still
+	// says what happened to each one
 	ShellInterface shell;
-	shell.ExecuteCommand(BuildCommand(path,
-		gitPushCmd + " " + remote + " " + branch));
+	shell.SetDeadline(GetDeadline(info));
+	ShellInterface::ProcessResult result;
+	shell.ExecuteCommand(BuildCommand(path, gitPushCmd, arguments), result);
+	ParsePushResults(result.stdOut, branches, results);
 
-	if (shell.GetExitCode() == 1)
+	unsigned int i;
+	for (i = 0; i < results.size(); i++)
 	{
-		std::cout << "fast-forward push not possible; ";
-		return false;
+		if (result.timedOut && !results[i].pushed && results[i].error.empty())
+			results[i].error = "timed out";
 	}
 
-	return shell.GetExitCode() == 0;
+	return results;
 }
 
-std::string GitInterface::GetLocalHead(const std::string& path,
-	const std::string& branch)
+void GitInterface::ParsePushResults(const std::string& porcelain,
+	const std::vector<std::string>& branches, std::vector<PushResult>& results)
 {
-	ShellInterface shell;
-	std::string stdOut;
-	if (!shell.ExecuteCommand(BuildCommand(path, "rev-parse " + branch), stdOut))
-		return "";
-	return CleanString(stdOut);
-}
+	// Each ref is reported as "<flag>\t<from>:<to>\t<summary> (<reason>)"
+	// where the flag is '!' for rejected refs
+	const std::string headsPrefix("refs/heads/");
+	std::istringstream ss(porcelain);
+	std::string line;
+	while (std::getline(ss, line))
+	{
+		const size_t firstTab(line.find('\t'));
+		const size_t secondTab(line.find('\t', firstTab + 1));
+		if (firstTab != 1 || secondTab == std::string::npos)
+			continue;
 
-std::string GitInterface::GetRemoteHead(const std::string& path,
-	const std::string &remote, const std::string& branch)
-{
-	ShellInterface shell;
-	std::string stdOut;
-	if (!shell.ExecuteCommand(BuildCommand(path,
-		"rev-parse refs/remotes/" + remote + "/" + branch), stdOut))
-		return "";
-	return CleanString(stdOut);
+		const std::string refspec(line.substr(firstTab + 1, secondTab - firstTab - 1));
+		const size_t colon(refspec.find(':'));
+		if (colon == std::string::npos ||
+			refspec.compare(colon + 1, headsPrefix.length(), headsPrefix) != 0)
+			continue;
+
+		const std::string branch(refspec.substr(colon + 1 + headsPrefix.length()));
+		const std::string summary(line.substr(secondTab + 1));
+		unsigned int i;
+		for (i = 0; i < branches.size(); i++)
+		{
+			if (branches[i].compare(branch) != 0)
+				continue;
+
+			results[i].pushed = line[0] != '!';
+			if (results[i].pushed)
+				continue;
+
+			const size_t open(summary.find('('));
+			const std::string reason(open == std::string::npos ? summary :
+				summary.substr(open + 1, summary.find(')', open) - open - 1));
+			if (reason.compare("non-fast-forward") == 0 ||
+				reason.compare("fetch first") == 0)
+				results[i].error = "fast-forward push not possible";
+			else
+				results[i].error = reason;
+		}
+	}
 }
 
-std::string GitInterface::BuildCommand(const std::string &path,
-	const std::string &command)
+ShellInterface::ArgumentList GitInterface::BuildCommand(
+	const std::string &path, const std::string &command,
+	const ShellInterface::ArgumentList& arguments)
 {
 	std::string gitDirPath(path);
 #ifdef _WIN32
@@ -286,49 +677,125 @@ std::string GitInterface::BuildCommand(const std::string &path,
 		gitDirPath.append("/");
 #endif
 	gitDirPath.append(".git");
-	return gitName + " " + gitDirectoryArgument + "\"" + gitDirPath + "\" "
-		+ gitWorkTreeArgument + "\"" + path + "\" " + command;
+
+	ShellInterface::ArgumentList commandLine;
+	commandLine.push_back(gitName);
+	commandLine.push_back(gitDirectoryArgument + gitDirPath);
+	commandLine.push_back(gitWorkTreeArgument + path);
+
+	ShellInterface::ArgumentList commandArguments(SplitArguments(command));
+	commandLine.insert(commandLine.end(), commandArguments.begin(), commandArguments.end());
+	commandLine.insert(commandLine.end(), arguments.begin(), arguments.end());
+
+	return commandLine;
+}
+
+ShellInterface::ArgumentList GitInterface::SplitArguments(
+	const std::string& command)
+{
+	ShellInterface::ArgumentList arguments;
+	std::istringstream ss(command);
+	std::string token;
+	while (ss >> token)
+		arguments.push_back(token);
+	return arguments;
 }
 
 GitInterface::RepositoryStatus GitInterface::CompareHeads(
 	const std::string& path, const RepositoryInfo& repoInfo,
-	const std::string& remote, const std::string& branch)
+	const std::string& remote, const std::string& branch) const
 {
-	std::string localHash;
+	PerformanceStats::PhaseTimer timer(PerformanceStats::PhaseCompare);
+	RepositoryStatus status;
+	const ObjectId localHash(FindHash(repoInfo.branches, branch));
+	if (localHash.IsNull())
+	{
+		status.code = StatusLocalMissingBranch;
+		return status;
+	}
+
+	ObjectId remoteHash;
 	unsigned int i;
-	for (i = 0; i < repoInfo.branches.size(); i++)
+	for (i = 0; i < repoInfo.remotes.size(); i++)
 	{
-		if (repoInfo.branches[i].name.compare(branch) == 0)
+		if (repoInfo.remotes[i].name == remote)
 		{
-			localHash = repoInfo.branches[i].hash;
+			remoteHash = FindHash(repoInfo.remotes[i].branches, branch);
 			break;
 		}
 	}
 
-	if (localHash.empty())
-		return StatusLocalMissingBranch;
-
-	ShellInterface shell;
-	std::string stdOut;
-	if (!shell.ExecuteCommand(BuildCommand(path, "rev-list " + remote + "/" + branch),
-		stdOut, ShellInterface::RedirectErrToOut))
-		std::cerr << "Failed to get revision list" << std::endl;
-	std::vector<std::string> hashes = SplitBufferByLine(stdOut);
-
-	const std::string ambiguousArgument("fatal: ambiguous argument");
-	for (i = 0; i < hashes.size(); i++)
+	if (remoteHash.IsNull())
+	{
+		status.code = StatusRemoteMissingBranch;
+		return status;
+	}
+	else if (remoteHash == localHash)
 	{
-		if (hashes[i].length() > ambiguousArgument.length() &&
-			hashes[i].substr(0, ambiguousArgument.length()).compare(ambiguousArgument) == 0)
-			return StatusRemoteMissingBranch;
+		status.code = StatusUpToDate;
+		return status;
+	}
 
-		if (hashes[i].compare(localHash) == 0)
+	if (!options.cache ||
+		!options.cache->LookupComparison(localHash.ToHex(), remoteHash.ToHex(), status))
+	{
+		// The history is usually readable directly; git is only needed for
+		// objects or history rewrites that the walker doesn't handle
+		const bool counted(repoInfo.history && repoInfo.history->CountAheadBehind(
+			localHash.GetRaw(), remoteHash.GetRaw(),
+			status.ahead, status.behind));
+		if (!counted)
 		{
-			if (i == 0)
-				return StatusUpToDate;
-			return StatusRemoteAhead;
+			// Counts only the commits on either side of the merge base, so the cost
+			// depends on how far the branches have diverged rather than history length
+			ShellInterface shell;
+			shell.SetDeadline(GetDeadline(repoInfo));
+			ShellInterface::ProcessResult result;
+			std::istringstream ss;
+			if (shell.ExecuteCommand(BuildCommand(path, gitCountAheadBehindCmd,
+				{ localHash.ToHex() + "..." + remoteHash.ToHex() }), result) &&
+				result.exitCode == 0)
+				ss.str(result.stdOut);
+			else if (result.timedOut)
+			{
+				status.code = StatusTimedOut;
+				return status;
+			}
+
+			if (!(ss >> status.ahead >> status.behind))
+			{
+				status.ahead = 0;
+				status.behind = 0;
+				status.code = StatusError;
+				return status;
+			}
 		}
+
+		if (options.cache)
+			options.cache->StoreComparison(localHash.ToHex(), remoteHash.ToHex(), status);
+	}
+
+	if (status.ahead > 0 && status.behind > 0)
+		status.code = StatusDiverged;
+	else if (status.ahead > 0)
+		status.code = StatusLocalAhead;
+	else if (status.behind > 0)
+		status.code = StatusRemoteAhead;
+	else
+		status.code = StatusUpToDate;
+
+	return status;
+}
+
+template <typename T>
+ObjectId GitInterface::FindHash(const std::vector<T>& refs, const std::string& name)
+{
+	unsigned int i;
+	for (i = 0; i < refs.size(); i++)
+	{
+		if (refs[i].name == name)
+			return refs[i].hash;
 	}
 
-	return StatusLocalAhead;
+	return ObjectId();
 }
@@ -9,96 +9,251 @@
 // Standard C++ headers
 #include <string>
 #include <vector>
+#include <memory>
+
+// Local headers
+#include "shellInterface.h"
+#include "fetchScheduler.h"
+#include "processExecutor.h"
+#include "nameTable.h"
+#include "objectId.h"
+
+class RefStore;
+class StatusCache;
+class JobLimiter;
+class CommitWalker;
 
 class GitInterface
 {
 public:
+	enum UntrackedMode
+	{
+		UntrackedNormal,// Report untracked files (directories are not expanded)
+		UntrackedNo// Skip the search for untracked files (-uno)
+	};
+
+	struct Options
+	{
+		Options() : untrackedMode(UntrackedNormal), fetchJobs(0),
+			fetchJobsPerHost(4), conditionalFetch(false), atomicPush(false),
+			countChanges(true), commandTimeout(0.0), repositoryTimeout(0.0),
+			cache(NULL), jobLimiter(NULL) {}
+
+		UntrackedMode untrackedMode;
+
+		// Limits on simultaneous fetches (zero for no limit)
+		unsigned int fetchJobs;
+		unsigned int fetchJobsPerHost;
+
+		// Compare the remote's advertised refs with our remote-tracking refs
+		// and only fetch when something differs
+		bool conditionalFetch;
+
+		// Push every branch to a remote or none of them
+		bool atomicPush;
+
+		// When false, git status is stopped as soon as it is known which kinds
+		// of changes exist, so the counts may be low
+		bool countChanges;
+
+		// Limits on how long one git command, and all of the commands for
+		// one repository, may run [sec] (zero for no limit)
+		double commandTimeout;
+		double repositoryTimeout;
+
+		// Remotes, refs and branch comparisons from previous runs (optional)
+		StatusCache* cache;
+
+		// Slots for checking submodules in parallel (optional)
+		JobLimiter* jobLimiter;
+	};
+
+	explicit GitInterface(const Options& options = Options());
 
 	struct BranchInfo
+	{
+		NameTable::Name name;
+		ObjectId hash;
+	};
+
+	// Tag names vary between repositories, so they aren't kept for the run
+	struct TagInfo
 	{
 		std::string name;
-		std::string hash;
+		ObjectId hash;
 	};
 
 	struct RemoteInfo
 	{
-		std::string name;
+		NameTable::Name name;
+		std::string url;
 		std::vector<BranchInfo> branches;
 	};
 
 	struct RepositoryInfo
 	{
 		std::string name;
+		std::string path;// Working tree
 		bool isGitRepository;
 
 		bool untrackedFiles;
 		bool unstagedChanges;
 		bool uncommittedChanges;
 
+		// Number of paths in each category
+		unsigned int untrackedCount;
+		unsigned int unstagedCount;
+		unsigned int uncommittedCount;
+		bool exactCounts;
+		bool timedOut;// Status could not be checked before the deadline
+
+		// Commands for this repository are terminated at this time
+		ShellInterface::Deadline deadline;
+
+		std::string currentBranch;
+
 		std::vector<BranchInfo> branches;
+		std::vector<TagInfo> tags;
 		std::vector<RemoteInfo> remotes;
 
 		std::vector<RepositoryInfo> subModules;
+
+		// Reads commits for branch comparisons (shared so each commit is only
+		// decoded once per repository)
+		std::shared_ptr<CommitWalker> history;
+
+		RepositoryInfo() : isGitRepository(false), untrackedFiles(false),
+			unstagedChanges(false), uncommittedChanges(false), untrackedCount(0),
+			unstagedCount(0), uncommittedCount(0), exactCounts(true), timedOut(false),
+			deadline(ShellInterface::NoDeadline()) {}
 	};
 
 	static std::string GetGitVersion();
-	static RepositoryInfo GetRepositoryInfo(const std::string& path);
-	bool FetchAll(const std::string& path, std::string& errorString);
-	bool PushToRemote(const std::string& path,
-		const std::string& remote, std::string& branch);
+	RepositoryInfo GetRepositoryInfo(const std::string& path) const;
+
+	// Re-reads local and remote-tracking branch heads (e.g. after fetching)
+	void UpdateRefs(const std::string& path, RepositoryInfo& info) const;
 
-	enum RepositoryStatus
+	enum FetchResult
+	{
+		FetchSucceeded,
+		FetchFailed,
+		FetchTimedOut// At least one remote timed out
+	};
+
+	struct FetchError
+	{
+		FetchError() : timedOut(false) {}
+
+		std::string remote;
+		std::string message;
+		bool timedOut;
+	};
+
+	FetchResult FetchAll(const std::string& path, const RepositoryInfo& info,
+		std::vector<FetchError>& errors);
+	struct PushResult
+	{
+		PushResult() : pushed(false) {}
+
+		bool pushed;
+		std::string error;// Reason the branch was not pushed, if known
+	};
+
+	// Pushes all of the branches (and tags) to the remote over one connection;
+	// results are in the same order as the branches
+	std::vector<PushResult> PushToRemote(const std::string& path,
+		const RepositoryInfo& info, const std::string& remote,
+		const std::vector<std::string>& branches) const;
+
+	enum StatusCode
 	{
 		StatusUpToDate,
 		StatusLocalAhead,
 		StatusRemoteAhead,
+		StatusDiverged,
 		StatusRemoteMissingBranch,
-		StatusLocalMissingBranch
+		StatusLocalMissingBranch,
+		StatusTimedOut,// Comparison did not finish before the deadline
+		StatusError// Comparison could not be made (e.g. missing objects)
+	};
+
+	struct RepositoryStatus
+	{
+		RepositoryStatus() : code(StatusUpToDate), ahead(0), behind(0) {}
+
+		StatusCode code;
+		unsigned int ahead;// Commits on the local branch but not the remote
+		unsigned int behind;// Commits on the remote branch but not the local
 	};
 
-	static RepositoryStatus CompareHeads(const std::string& path,
+	RepositoryStatus CompareHeads(const std::string& path,
 		const RepositoryInfo& repoInfo, const std::string& remote,
-		const std::string& branch);
+		const std::string& branch) const;
 
 private:
+	const Options options;
+	FetchScheduler fetchScheduler;
+	ProcessExecutor executor;
+
 	static const std::string gitName;
 	static const std::string gitDirectoryArgument;
 	static const std::string gitWorkTreeArgument;
 	static const std::string gitGetVersionCmd;
-	static const std::string gitGetUntrackedFilesCmd;
-	static const std::string gitGetUnstagedChangesCmd;
-	static const std::string gitGetUncommittedChangesCmd;
-	static const std::string gitListBranchesCmd;
-	static const std::string gitListRemoteBranchesCmd;
-	static const std::string gitGetCurrentBranchCmd;
+	static const std::string gitStatusCmd;
+	static const std::string gitNoUntrackedArgument;
+	static const std::string gitDiffCachedCmd;
+	static const std::string gitListRefsCmd;
+	static const std::string gitListRefsFormat;
 	static const std::string gitListRemotesCmd;
-	static const std::string gitFetchAllCmd;
-	static const std::string gitFailMessage;
+	static const std::string gitFetchCmd;
+	static const std::string gitListRemoteRefsCmd;
 	static const std::string gitPushCmd;
+	static const std::string gitAtomicArgument;
+	static const std::string gitCountAheadBehindCmd;
 
-	static std::string GetLocalHead(const std::string& path,
-		const std::string& branch);
-	static std::string GetRemoteHead(const std::string& path,
-		const std::string &remote, const std::string& branch);
-
-	static std::string BuildCommand(const std::string& path,
-		const std::string& command);
+	static ShellInterface::ArgumentList BuildCommand(const std::string& path,
+		const std::string& command,
+		const ShellInterface::ArgumentList& arguments = ShellInterface::ArgumentList());
+	static ShellInterface::ArgumentList SplitArguments(const std::string& command);
 
 	static std::string ExtractLastDirectory(const std::string& path);
-	static std::vector<std::string> SplitBufferByLine(const std::string& buffer);
-
-	static std::vector<RemoteInfo> BuildRemotes(const std::string& path,
-		const std::vector<std::string>& remotes);
-	static RemoteInfo BuildRemote(const std::string& path,
-		const std::string& remote);
-	static std::vector<BranchInfo> BuildBranches(const std::string& path,
-		const std::vector<std::string>& branches);
-	static BranchInfo BuildBranch(const std::string& path,
-		const std::string& branch);
-	static BranchInfo BuildBranch(const std::string& path,
-		const std::string& remote, const std::string& branch);
-
-	static std::string CleanString(const std::string &name);
+
+	// Returns true once the line answers every remaining question about the
+	// working tree (porcelain v2 lists all tracked changes before untracked files)
+	static bool ParseStatusLine(const std::string& line, RepositoryInfo& info,
+		const UntrackedMode& untrackedMode);
+
+	static void ReadRefs(const std::string& path, RepositoryInfo& info);
+	static bool ReadRefSnapshot(const std::string& path, RefStore& refStore);
+	static std::vector<RemoteInfo> ParseRemotes(const std::string& remoteList);
+	static void BuildRemoteBranches(const RefStore& refStore,
+		std::vector<RemoteInfo>& remotes);
+	static std::vector<BranchInfo> BuildBranches(const RefStore& refStore);
+	static std::vector<TagInfo> BuildTags(const RefStore& refStore);
+
+	// Working tree status, remotes and refs; returns false if path is not a
+	// repository
+	bool ReadState(const std::string& path, RepositoryInfo& info) const;
+	bool ReadStatus(const std::string& path, RepositoryInfo& info) const;
+
+	// Answers the same questions as git status -uno without walking the
+	// working tree in git; returns false if git is needed
+	bool ReadNativeStatus(const std::string& path, RepositoryInfo& info) const;
+
+	// The earlier of the command timeout and the repository's deadline
+	ShellInterface::Deadline GetDeadline(const RepositoryInfo& info) const;
+	static std::vector<std::string> FindSubModules(const std::string& path);
+
+	static bool RemoteIsUnchanged(const std::string& advertisedRefs,
+		const RepositoryInfo& info, const RemoteInfo& remote);
+
+	static void ParsePushResults(const std::string& porcelain,
+		const std::vector<std::string>& branches, std::vector<PushResult>& results);
+
+	// Works with branches or tags; returns a null ID if not found
+	template <typename T>
+	static ObjectId FindHash(const std::vector<T>& refs, const std::string& name);
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,238 @@
+// File:  indexFile.cpp
+// Date:  10/18/2026
+// Auth:  agent
+// Desc:  Reads the entries of a git index file (versions 2 through 4).
+
+// Standard C/C++ headers
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <sys/stat.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+// Local headers
+#include "indexFile.h"
+
+bool IndexFile::Read(const std::string& fileName, const size_t& hashLength)
+{
+	entries.clear();
+	extensions.clear();
+
+	struct stat info;
+	if (stat(fileName.c_str(), &info) != 0)
+		return false;
+
+	fileSeconds = static_cast<uint32_t>(info.st_mtime);
+#if defined(__linux__)
+	fileNanoseconds = static_cast<uint32_t>(info.st_mtim.tv_nsec);
+#elif defined(__APPLE__)
+	fileNanoseconds = static_cast<uint32_t>(info.st_mtimespec.tv_nsec);
+#else
+	fileNanoseconds = 0;
+#endif
+
+#ifdef _WIN32
+	std::ifstream file(fileName.c_str(), std::ios::binary);
+	if (!file.is_open())
+		return false;
+
+	std::ostringstream ss;
+	ss << file.rdbuf();
+	const std::string contents(ss.str());
+	return Parse(reinterpret_cast<const unsigned char*>(contents.c_str()),
+		contents.length(), hashLength);
+#else
+	const int fd(open(fileName.c_str(), O_RDONLY | O_CLOEXEC));
+	if (fd < 0)
+		return false;
+
+	if (fstat(fd, &info) != 0 || info.st_size == 0)
+	{
+		close(fd);
+		return false;
+	}
+
+	void* data(mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0));
+	close(fd);
+	if (data == MAP_FAILED)
+		return false;
+
+	const bool ok(Parse(static_cast<const unsigned char*>(data), info.st_size,
+		hashLength));
+	munmap(data, info.st_size);
+	return ok;
+#endif
+}
+
+bool IndexFile::Parse(const unsigned char* data, const size_t& size,
+	const size_t& hashLength)
+{
+	const size_t headerSize(12);
+	if (size < headerSize + hashLength || memcmp(data, "DIRC", 4) != 0)
+		return false;
+
+	version = ReadBigEndian32(data + 4);
+	objectIdLength = hashLength;
+	if (version < 2 || version > 4)
+		return false;
+
+	const uint32_t count(ReadBigEndian32(data + 8));
+	const size_t statSize(40);
+	const size_t end(size - hashLength);// Trailing checksum
+	size_t position(headerSize);
+	std::string previousPath;
+
+	entries.reserve(count);
+	uint32_t i;
+	for (i = 0; i < count; i++)
+	{
+		const size_t fixedSize(statSize + hashLength + 2);
+		if (position + fixedSize > end)
+			return false;
+
+		const unsigned char* p(data + position);
+		Entry entry;
+		entry.ctimeSeconds = ReadBigEndian32(p);
+		entry.ctimeNanoseconds = ReadBigEndian32(p + 4);
+		entry.mtimeSeconds = ReadBigEndian32(p + 8);
+		entry.mtimeNanoseconds = ReadBigEndian32(p + 12);
+		entry.device = ReadBigEndian32(p + 16);
+		entry.inode = ReadBigEndian32(p + 20);
+		entry.mode = ReadBigEndian32(p + 24);
+		entry.uid = ReadBigEndian32(p + 28);
+		entry.gid = ReadBigEndian32(p + 32);
+		entry.size = ReadBigEndian32(p + 36);
+		entry.objectId.assign(reinterpret_cast<const char*>(p + statSize), hashLength);
+		entry.flags = ReadBigEndian16(p + statSize + hashLength);
+		entry.extendedFlags = 0;
+
+		size_t nameStart(position + fixedSize);
+		if (version >= 3 && (entry.flags & 0x4000))
+		{
+			if (nameStart + 2 > end)
+				return false;
+			entry.extendedFlags = ReadBigEndian16(data + nameStart);
+			nameStart += 2;
+		}
+
+		if (version == 4)
+		{
+			// Path is stored as the number of bytes to remove from the end of
+			// the previous path, followed by the new suffix
+			size_t strip(0);
+			unsigned char c;
+			do
+			{
+				if (nameStart >= end)
+					return false;
+				c = data[nameStart++];
+				strip = (strip << 7) | (c & 0x7f);
+				if (c & 0x80)
+					strip++;
+			} while (c & 0x80);
+
+			if (strip > previousPath.length())
+				return false;
+
+			const void* nul(memchr(data + nameStart, 0, end - nameStart));
+			if (!nul)
+				return false;
+
+			const size_t suffixLength(static_cast<const unsigned char*>(nul) - (data + nameStart));
+			entry.path = previousPath.substr(0, previousPath.length() - strip) +
+				std::string(reinterpret_cast<const char*>(data + nameStart), suffixLength);
+			position = nameStart + suffixLength + 1;
+			previousPath = entry.path;
+		}
+		else
+		{
+			const void* nul(memchr(data + nameStart, 0, end - nameStart));
+			if (!nul)
+				return false;
+
+			const size_t nameLength(static_cast<const unsigned char*>(nul) - (data + nameStart));
+			entry.path.assign(reinterpret_cast<const char*>(data + nameStart), nameLength);
+
+			// Entries are padded with 1-8 NUL bytes to a multiple of eight
+			position += ((nameStart - position) + nameLength + 8) & ~static_cast<size_t>(7);
+		}
+
+		entries.push_back(entry);
+	}
+
+	while (position + 8 <= end)
+	{
+		const std::string signature(reinterpret_cast<const char*>(data + position), 4);
+		const uint32_t length(ReadBigEndian32(data + position + 4));
+		if (position + 8 + length > end)
+			return false;
+
+		extensions.push_back(std::make_pair(signature,
+			std::string(reinterpret_cast<const char*>(data + position + 8), length)));
+		position += 8 + length;
+	}
+
+	return true;
+}
+
+std::string IndexFile::GetExtension(const std::string& signature) const
+{
+	unsigned int i;
+	for (i = 0; i < extensions.size(); i++)
+	{
+		if (extensions[i].first.compare(signature) == 0)
+			return extensions[i].second;
+	}
+
+	return std::string();
+}
+
+bool IndexFile::HasExtension(const std::string& signature) const
+{
+	unsigned int i;
+	for (i = 0; i < extensions.size(); i++)
+	{
+		if (extensions[i].first.compare(signature) == 0)
+			return true;
+	}
+
+	return false;
+}
+
+bool IndexFile::GetCacheTreeRoot(std::string& treeId) const
+{
+	// The root comes first:  an empty path, NUL, the entry count (-1 once
+	// invalidated), a space, the subtree count, a newline and the tree ID
+	const std::string cacheTree(GetExtension("TREE"));
+	if (cacheTree.empty() || cacheTree[0] != '\0')
+		return false;
+
+	const size_t newline(cacheTree.find('\n'));
+	if (newline == std::string::npos ||
+		cacheTree.length() < newline + 1 + objectIdLength)
+		return false;
+
+	std::istringstream counts(cacheTree.substr(1, newline - 1));
+	int entryCount, subtreeCount;
+	if (!(counts >> entryCount >> subtreeCount) || entryCount < 0)
+		return false;
+
+	treeId = cacheTree.substr(newline + 1, objectIdLength);
+	return true;
+}
+
+uint32_t IndexFile::ReadBigEndian32(const unsigned char* p)
+{
+	return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+		(static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+}
+
+uint16_t IndexFile::ReadBigEndian16(const unsigned char* p)
+{
+	return static_cast<uint16_t>((p[0] << 8) | p[1]);
+}
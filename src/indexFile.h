@@ -0,0 +1,76 @@
+// File:  indexFile.h
+// Date:  10/18/2026
+// Auth:  agent
+// Desc:  Reads the entries of a git index file (versions 2 through 4).
+
+#ifndef INDEX_FILE_H_
+#define INDEX_FILE_H_
+
+// Standard C++ headers
+#include <string>
+#include <vector>
+#include <cstdint>
+
+class IndexFile
+{
+public:
+	struct Entry
+	{
+		uint32_t ctimeSeconds;
+		uint32_t ctimeNanoseconds;
+		uint32_t mtimeSeconds;
+		uint32_t mtimeNanoseconds;
+		uint32_t device;
+		uint32_t inode;
+		uint32_t mode;
+		uint32_t uid;
+		uint32_t gid;
+		uint32_t size;
+		std::string objectId;// Raw bytes
+		uint16_t flags;
+		uint16_t extendedFlags;
+		std::string path;
+
+		// Merge stage (non-zero for conflicted entries)
+		unsigned int GetStage() const { return (flags >> 12) & 0x3; }
+		bool IsAssumeValid() const { return (flags & 0x8000) != 0; }// Assume unchanged
+		bool IsGitlink() const { return (mode & 0170000) == 0160000; }
+		bool IsSkipWorktree() const { return (extendedFlags & 0x4000) != 0; }
+		bool IsIntentToAdd() const { return (extendedFlags & 0x2000) != 0; }
+	};
+
+	// The hash length is 20 for SHA-1 repositories and 32 for SHA-256
+	bool Read(const std::string& fileName, const size_t& hashLength = 20);
+
+	unsigned int GetVersion() const { return version; }
+	const std::vector<Entry>& GetEntries() const { return entries; }
+
+	// Modification time of the index file itself (entries changed in the same
+	// second as the index was written may be "racily clean")
+	uint32_t GetFileSeconds() const { return fileSeconds; }
+	uint32_t GetFileNanoseconds() const { return fileNanoseconds; }
+
+	// Raw contents of an extension (e.g. "TREE"), or empty if not present
+	std::string GetExtension(const std::string& signature) const;
+	bool HasExtension(const std::string& signature) const;
+
+	// ID (raw bytes) of the tree that writing the index would produce, taken
+	// from the cache-tree extension; false if it's missing or invalidated
+	bool GetCacheTreeRoot(std::string& treeId) const;
+
+private:
+	unsigned int version;
+	size_t objectIdLength;
+	uint32_t fileSeconds;
+	uint32_t fileNanoseconds;
+	std::vector<Entry> entries;
+	std::vector<std::pair<std::string, std::string> > extensions;
+
+	bool Parse(const unsigned char* data, const size_t& size,
+		const size_t& hashLength);
+
+	static uint32_t ReadBigEndian32(const unsigned char* p);
+	static uint16_t ReadBigEndian16(const unsigned char* p);
+};
+
+#endif// INDEX_FILE_H_
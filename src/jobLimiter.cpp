@@ -0,0 +1,71 @@
+// File:  jobLimiter.cpp
+// Date:  10/18/2026
+// Auth:  agent
+// Desc:  Shares job slots between repository checks and the work they fan out to.
+
+// Standard C++ headers
+#include <thread>
+#include <vector>
+#include <cassert>
+
+// Local headers
+#include "jobLimiter.h"
+
+JobLimiter::JobLimiter(const unsigned int& limit) : limit(limit)
+{
+	activeCount = 0;
+}
+
+void JobLimiter::Acquire()
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	released.wait(lock, [this]()
+	{
+		return activeCount < limit;
+	});
+	activeCount++;
+}
+
+bool JobLimiter::TryAcquire()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+	if (activeCount >= limit)
+		return false;
+	activeCount++;
+	return true;
+}
+
+void JobLimiter::Release()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		assert(activeCount > 0);
+		activeCount--;
+	}
+	released.notify_one();
+}
+
+void JobLimiter::ForEach(const unsigned int& count,
+	const std::function<void(const unsigned int&)>& function)
+{
+	std::vector<std::thread> threads;
+	unsigned int i;
+	for (i = 0; i < count; i++)
+	{
+		// The last call always runs here, since this thread would otherwise
+		// only be waiting
+		if (i + 1 < count && TryAcquire())
+		{
+			threads.push_back(std::thread([this, &function, i]()
+			{
+				function(i);
+				Release();
+			}));
+		}
+		else
+			function(i);
+	}
+
+	for (i = 0; i < threads.size(); i++)
+		threads[i].join();
+}
@@ -0,0 +1,38 @@
+// File:  jobLimiter.h
+// Date:  10/18/2026
+// Auth:  agent
+// Desc:  Shares a fixed number of job slots between repository checks and the
+//        extra work (e.g. submodules) they fan out to.
+
+#ifndef JOB_LIMITER_H_
+#define JOB_LIMITER_H_
+
+// Standard C++ headers
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+class JobLimiter
+{
+public:
+	explicit JobLimiter(const unsigned int& limit);
+
+	void Acquire();
+	bool TryAcquire();
+	void Release();
+
+	// Calls function for each index from zero to count - 1.  Calls run on new
+	// threads while free slots are available, otherwise on the calling thread,
+	// so nested use can never deadlock.  Returns when all calls are complete.
+	void ForEach(const unsigned int& count,
+		const std::function<void(const unsigned int&)>& function);
+
+private:
+	const unsigned int limit;
+	unsigned int activeCount;
+
+	std::mutex mutex;
+	std::condition_variable released;
+};
+
+#endif// JOB_LIMITER_H_
@@ -7,11 +7,407 @@
 #include <cstdlib>
 #include <iostream>
 #include <fstream>
+#include <sstream>
 #include <utility>
+#include <memory>
+#include <chrono>
 
 // Local headers
 #include "gitInterface.h"
-#include "fileSystemNavigator.h"
+#include "repositoryFinder.h"
+#include "scanEngine.h"
+#include "statusCache.h"
+#include "repositoryWatcher.h"
+#include "jobLimiter.h"
+#include "performanceStats.h"
+#include "traceRecorder.h"
+#include "repositoryReport.h"
+#include "outputWriter.h"
+#include "stringUtilities.h"
+
+enum OutputFormat
+{
+	FormatText,
+	FormatJsonLines// One JSON record per line
+};
+
+struct CheckSettings
+{
+	bool fetch;
+	OutputFormat format;
+};
+
+static void PrintUsage(const std::string& name)
+{
+	std::cerr << "Usage:  " << name << " [options] <search path>\n"
+		<< "  -j <jobs>             Number of repositories to check concurrently (default 1)\n"
+		<< "  --depth=<n>           Directory levels to search for repositories (default 1, 0 for unlimited)\n"
+		<< "  --untracked=<mode>    normal (default) or no to skip looking for untracked files\n"
+		<< "  --no-counts           Stop checking for changes once each kind is found (counts are not shown)\n"
+		<< "  --fetch-jobs=<n>      Maximum simultaneous fetches (default unlimited)\n"
+		<< "  --fetch-jobs-per-host=<n>\n"
+		<< "                        Maximum simultaneous fetches from one host (default 4)\n"
+		<< "  --conditional-fetch   Only fetch from remotes whose advertised refs differ from ours\n"
+		<< "  --atomic-push         Push either all of a remote's ahead branches or none of them\n"
+		<< "  --timeout=<sec>       Terminate any git command that runs longer (default no limit)\n"
+		<< "  --repo-timeout=<sec>  Terminate git commands once a repository has taken this long\n"
+		<< "  --cache=<file>        Reuse refs and branch comparisons from previous runs\n"
+		<< "  --watch               Keep running and re-check repositories when they change\n"
+		<< "  --stats               Print time, process count and memory use for each phase\n"
+		<< "  --trace <file>        Write a Chrome trace (for Perfetto) of every repository, phase and command\n"
+		<< "  --format=<format>     text (default) or jsonl for one JSON record per repository"
+		<< std::endl;
+}
+
+static bool ParseArguments(int argc, char *argv[], unsigned int& jobCount,
+	unsigned int& searchDepth, GitInterface::Options& gitOptions,
+	std::string& cacheFileName, bool& watch, std::string& traceFileName,
+	OutputFormat& format, std::string& searchPath)
+{
+	jobCount = 1;
+	searchDepth = 1;
+	watch = false;
+	format = FormatText;
+	cacheFileName.clear();
+	traceFileName.clear();
+	searchPath.clear();
+
+	const std::string depthArgument("--depth=");
+	const std::string untrackedArgument("--untracked=");
+	const std::string fetchJobsArgument("--fetch-jobs=");
+	const std::string fetchJobsPerHostArgument("--fetch-jobs-per-host=");
+	const std::string cacheArgument("--cache=");
+	const std::string timeoutArgument("--timeout=");
+	const std::string repoTimeoutArgument("--repo-timeout=");
+	const std::string formatArgument("--format=");
+
+	int i;
+	for (i = 1; i < argc; i++)
+	{
+		std::string arg(argv[i]);
+		if (arg.compare(0, 2, "-j") == 0)
+		{
+			std::string value(arg.substr(2));
+			if (value.empty())
+			{
+				if (++i >= argc)
+					return false;
+				value = argv[i];
+			}
+
+			std::istringstream ss(value);
+			if (!(ss >> jobCount) || jobCount == 0)
+				return false;
+		}
+		else if (arg.compare(0, depthArgument.length(), depthArgument) == 0)
+		{
+			std::istringstream ss(arg.substr(depthArgument.length()));
+			if (!(ss >> searchDepth))
+				return false;
+		}
+		else if (arg.compare(0, untrackedArgument.length(), untrackedArgument) == 0)
+		{
+			const std::string mode(arg.substr(untrackedArgument.length()));
+			if (mode.compare("normal") == 0)
+				gitOptions.untrackedMode = GitInterface::UntrackedNormal;
+			else if (mode.compare("no") == 0)
+				gitOptions.untrackedMode = GitInterface::UntrackedNo;
+			else
+				return false;
+		}
+		else if (arg.compare("--no-counts") == 0)
+			gitOptions.countChanges = false;
+		else if (arg.compare(0, fetchJobsArgument.length(), fetchJobsArgument) == 0)
+		{
+			std::istringstream ss(arg.substr(fetchJobsArgument.length()));
+			if (!(ss >> gitOptions.fetchJobs))
+				return false;
+		}
+		else if (arg.compare(0, fetchJobsPerHostArgument.length(), fetchJobsPerHostArgument) == 0)
+		{
+			std::istringstream ss(arg.substr(fetchJobsPerHostArgument.length()));
+			if (!(ss >> gitOptions.fetchJobsPerHost))
+				return false;
+		}
+		else if (arg.compare("--conditional-fetch") == 0)
+			gitOptions.conditionalFetch = true;
+		else if (arg.compare("--atomic-push") == 0)
+			gitOptions.atomicPush = true;
+		else if (arg.compare(0, timeoutArgument.length(), timeoutArgument) == 0)
+		{
+			std::istringstream ss(arg.substr(timeoutArgument.length()));
+			if (!(ss >> gitOptions.commandTimeout) || gitOptions.commandTimeout < 0.0)
+				return false;
+		}
+		else if (arg.compare(0, repoTimeoutArgument.length(), repoTimeoutArgument) == 0)
+		{
+			std::istringstream ss(arg.substr(repoTimeoutArgument.length()));
+			if (!(ss >> gitOptions.repositoryTimeout) || gitOptions.repositoryTimeout < 0.0)
+				return false;
+		}
+		else if (arg.compare(0, cacheArgument.length(), cacheArgument) == 0)
+		{
+			cacheFileName = arg.substr(cacheArgument.length());
+			if (cacheFileName.empty())
+				return false;
+		}
+		else if (arg.compare(0, formatArgument.length(), formatArgument) == 0)
+		{
+			const std::string name(arg.substr(formatArgument.length()));
+			if (name.compare("text") == 0)
+				format = FormatText;
+			else if (name.compare("jsonl") == 0)
+				format = FormatJsonLines;
+			else
+				return false;
+		}
+		else if (arg.compare("--watch") == 0)
+			watch = true;
+		else if (arg.compare("--stats") == 0)
+			PerformanceStats::Enable();
+		else if (arg.compare(0, 7, "--trace") == 0)
+		{
+			if (arg.length() > 8 && arg[7] == '=')
+				traceFileName = arg.substr(8);
+			else if (arg.length() == 7 && ++i < argc)
+				traceFileName = argv[i];
+			else
+				return false;
+			TraceRecorder::Enable();
+		}
+		else if (searchPath.empty())
+			searchPath = arg;
+		else
+			return false;
+	}
+
+	return !searchPath.empty();
+}
+
+// Joins output blocks, keeping the blank lines between them consistent
+static void AppendResult(const ScanEngine::Result& part, ScanEngine::Result& combined)
+{
+	if (part.output.empty())
+		return;
+
+	if (combined.output.empty())
+		combined.separate = part.separate;
+	else if (part.separate && combined.needsSpaceAfter)
+		combined.output.append("\n");
+
+	combined.output.append(part.output);
+	combined.needsSpaceAfter = part.needsSpaceAfter;
+}
+
+// Fetches, compares and pushes as needed, recording everything in the report
+static void BuildReport(GitInterface& gitIface, GitInterface::RepositoryInfo& repoInfo,
+	const bool& fetch, RepositoryReport& report)
+{
+	report.uncommittedCount = repoInfo.uncommittedCount;
+	report.unstagedCount = repoInfo.unstagedCount;
+	report.untrackedCount = repoInfo.untrackedCount;
+	report.exactCounts = repoInfo.exactCounts;
+	report.statusTimedOut = repoInfo.timedOut;
+	report.remoteCount = repoInfo.remotes.size();
+	if (report.statusTimedOut || report.IsDirty() || report.remoteCount == 0)
+		return;
+
+	if (fetch)
+	{
+		const std::chrono::steady_clock::time_point start(std::chrono::steady_clock::now());
+		const GitInterface::FetchResult fetchResult(
+			gitIface.FetchAll(repoInfo.path, repoInfo, report.fetchErrors));
+		if (fetchResult == GitInterface::FetchSucceeded)
+			report.fetchState = RepositoryReport::FetchSucceeded;
+		else if (fetchResult == GitInterface::FetchTimedOut)
+			report.fetchState = RepositoryReport::FetchTimedOut;
+		else
+			report.fetchState = RepositoryReport::FetchFailed;
+		if (report.fetchState == RepositoryReport::FetchSucceeded)
+			gitIface.UpdateRefs(repoInfo.path, repoInfo);
+		report.fetchTime = std::chrono::duration<double>(
+			std::chrono::steady_clock::now() - start).count();
+
+		if (report.fetchState != RepositoryReport::FetchSucceeded)
+			return;
+	}
+
+	unsigned int j, k;
+	for (j = 0; j < repoInfo.remotes.size(); j++)
+	{
+		const size_t first(report.branches.size());
+		std::vector<std::string> pushBranches;
+		std::vector<size_t> pushIndices;
+		for (k = 0; k < repoInfo.branches.size(); k++)
+		{
+			RepositoryReport::BranchReport branch;
+			branch.remote = repoInfo.remotes[j].name;
+			branch.branch = repoInfo.branches[k].name;
+
+			std::chrono::steady_clock::time_point start(std::chrono::steady_clock::now());
+			branch.status = gitIface.CompareHeads(repoInfo.path, repoInfo,
+				branch.remote, branch.branch);
+			report.compareTime += std::chrono::duration<double>(
+				std::chrono::steady_clock::now() - start).count();
+
+			if (branch.status.code == GitInterface::StatusLocalAhead ||
+				branch.status.code == GitInterface::StatusRemoteMissingBranch)
+			{
+				pushBranches.push_back(branch.branch);
+				pushIndices.push_back(first + k);
+			}
+
+			report.branches.push_back(branch);
+		}
+
+		if (pushBranches.empty())
+			continue;
+
+		// One push per remote so the connection (and authentication) is shared
+		std::chrono::steady_clock::time_point start(std::chrono::steady_clock::now());
+		const std::vector<GitInterface::PushResult> pushResults(gitIface.PushToRemote(
+			repoInfo.path, repoInfo, repoInfo.remotes[j].name, pushBranches));
+		report.pushTime += std::chrono::duration<double>(
+			std::chrono::steady_clock::now() - start).count();
+
+		for (k = 0; k < pushResults.size(); k++)
+		{
+			RepositoryReport::BranchReport& branch(report.branches[pushIndices[k]]);
+			branch.action = pushResults[k].pushed ?
+				RepositoryReport::BranchReport::ActionPushed :
+				RepositoryReport::BranchReport::ActionPushFailed;
+			branch.error = pushResults[k].error;
+		}
+	}
+}
+
+static void ReportRepository(GitInterface& gitIface, JobLimiter& jobLimiter,
+	const CheckSettings& settings, GitInterface::RepositoryInfo& repoInfo,
+	RepositoryReport& report, ScanEngine::Result& result)
+{
+	report.name = repoInfo.name;
+	report.path = repoInfo.path;
+	BuildReport(gitIface, repoInfo, settings.fetch, report);
+
+	if (settings.format == FormatJsonLines)
+		result.output = report.FormatJson();
+	else
+		result.output = report.FormatText(result.separate, result.needsSpaceAfter);
+
+	// Submodules are reported after their superproject, in path order (their
+	// status time is included in the superproject's)
+	std::vector<ScanEngine::Result> subModuleResults(repoInfo.subModules.size());
+	jobLimiter.ForEach(repoInfo.subModules.size(), [&](const unsigned int& i)
+	{
+		RepositoryReport subModuleReport;
+		subModuleReport.isSubModule = true;
+		ReportRepository(gitIface, jobLimiter, settings, repoInfo.subModules[i],
+			subModuleReport, subModuleResults[i]);
+	});
+
+	unsigned int i;
+	for (i = 0; i < subModuleResults.size(); i++)
+		AppendResult(subModuleResults[i], result);
+}
+
+static void CheckRepository(GitInterface& gitIface, JobLimiter& jobLimiter,
+	const CheckSettings& settings, const std::string& repoPath,
+	ScanEngine::Result& result)
+{
+	TraceRecorder::Span span("repository", repoPath);
+
+	const std::string ignoreFileName(".ignore");
+	std::ifstream ignoreFile((repoPath + ignoreFileName).c_str());
+	if (ignoreFile.is_open())
+	{
+		result.type = ScanEngine::Result::TypeIgnored;
+		return;
+	}
+
+	const std::chrono::steady_clock::time_point start(std::chrono::steady_clock::now());
+	GitInterface::RepositoryInfo repoInfo(gitIface.GetRepositoryInfo(repoPath));
+	if (!repoInfo.isGitRepository && !repoInfo.timedOut)
+	{
+		result.type = ScanEngine::Result::TypeNotRepository;
+		return;
+	}
+
+	result.type = ScanEngine::Result::TypeRepository;
+	RepositoryReport report;
+	report.statusTime = std::chrono::duration<double>(
+		std::chrono::steady_clock::now() - start).count();
+	ReportRepository(gitIface, jobLimiter, settings, repoInfo, report, result);
+}
+
+// Runs until killed, re-checking repositories (without fetching) whenever
+// their metadata or the top level of their working tree changes
+static bool WatchRepositories(GitInterface& gitIface, JobLimiter& jobLimiter,
+	const unsigned int& jobCount, const OutputFormat& format,
+	const std::vector<std::string>& repoPaths, StatusCache* cache,
+	const std::string& traceFileName, OutputWriter& writer)
+{
+	RepositoryWatcher watcher;
+	if (!watcher.Initialize())
+	{
+		std::cerr << "Failed to start watching for changes" << std::endl;
+		return false;
+	}
+
+	unsigned int i;
+	for (i = 0; i < repoPaths.size(); i++)
+	{
+		if (!watcher.Add(repoPaths[i]))
+			std::cerr << "Failed to watch '" << repoPaths[i] << "' for changes" << std::endl;
+	}
+
+	// Editors and git itself write several files for each change
+	const unsigned int debounceTime(2000);// [msec]
+
+	if (format == FormatText)
+		writer.Write("\nWatching for changes...\n");
+	writer.Flush();
+
+	CheckSettings settings;
+	settings.fetch = false;
+	settings.format = format;
+	bool needsSpace(true);
+	while (true)
+	{
+		const std::vector<std::string> changed(watcher.WaitForChanges(debounceTime));
+
+		ScanEngine engine(jobCount, [&](const std::string& repoPath,
+			ScanEngine::Result& result)
+		{
+			jobLimiter.Acquire();
+			CheckRepository(gitIface, jobLimiter, settings, repoPath, result);
+			jobLimiter.Release();
+		}, [&](const ScanEngine::Result& result)
+		{
+			watcher.MarkChecked(result.path);
+			if (result.output.empty())
+				return;
+
+			if (result.separate && needsSpace)
+				writer.Write("\n");
+			writer.Write(result.output);
+			needsSpace = result.needsSpaceAfter;
+		}, [&writer]()
+		{
+			writer.Flush();
+		});
+
+		for (i = 0; i < changed.size(); i++)
+			engine.Enqueue(changed[i]);
+		engine.Finish();
+
+		if (cache)
+			cache->Save();
+		if (TraceRecorder::IsEnabled())
+			TraceRecorder::Write(traceFileName);
+	}
+
+	return true;
+}
 
 int main(int argc, char *argv[])
 {
@@ -21,154 +417,135 @@ int main(int argc, char *argv[])
 		std::cerr << "Failed to find git.  Make sure it is installed and on your path." << std::endl;
 		return 1;
 	}
-	std::cout << gitVersion << std::endl;
 
-	if (argc < 2)
+	unsigned int jobCount, searchDepth;
+	GitInterface::Options gitOptions;
+	std::string cacheFileName, traceFileName, searchPath;
+	bool watch;
+	OutputFormat format;
+	if (!ParseArguments(argc, argv, jobCount, searchDepth, gitOptions,
+		cacheFileName, watch, traceFileName, format, searchPath))
 	{
-		std::cerr << "" << std::endl;
+		PrintUsage(argv[0]);
+		return 1;
+	}
+
+	OutputWriter writer;
+	if (format == FormatJsonLines)
+		writer.Write("{\"type\":\"start\",\"gitVersion\":\"" +
+			EscapeJson(Trim(gitVersion)) + "\"}\n");
+	else
+		writer.Write(gitVersion + "\n");
+	writer.Flush();
+	if (watch && !RepositoryWatcher::IsSupported())
+	{
+		std::cerr << "Watching for changes is not supported on this platform" << std::endl;
 		return 1;
 	}
-	std::string searchPath(argv[1]);
 	if (searchPath.back() != '/')
 		searchPath.append("/");
 
-	GitInterface gitIface;
-	std::string repoPath;
-	std::vector<GitInterface::RepositoryInfo> repoInfo;
-	std::vector<std::string> directories(
-		FileSystemNavigator::GetAllSubdirectories(searchPath));
-	unsigned int i, repoCount(0), ignoreCount(0), nonRepoCount(0);
-	const std::string ignoreFileName(".ignore");
+	std::unique_ptr<StatusCache> cache;
+	if (!cacheFileName.empty())
+	{
+		// A missing or unreadable cache just means everything is checked
+		cache.reset(new StatusCache(cacheFileName));
+		cache->Load();
+		gitOptions.cache = cache.get();
+	}
+
+	// Submodules use whatever slots aren't taken by repository checks
+	JobLimiter jobLimiter(jobCount);
+	gitOptions.jobLimiter = &jobLimiter;
+
+	GitInterface gitIface(gitOptions);
+	unsigned int repoCount(0), ignoreCount(0), nonRepoCount(0);
 	bool needsSpace(false);
-	for (i = 0; i < directories.size(); i++)
+	std::vector<std::string> repoPaths;
+
+	// Called in directory order (one at a time) as results become available
+	ScanEngine::EmitFunction emit = [&](const ScanEngine::Result& result)
 	{
-		repoPath = searchPath + directories[i] + "/";
-		std::ifstream ignoreFile((repoPath + ignoreFileName).c_str());
-		if (ignoreFile.is_open())
+		if (result.type == ScanEngine::Result::TypeIgnored)
 		{
 			ignoreCount++;
-			continue;
-		}
-
-		repoInfo.push_back(GitInterface::GetRepositoryInfo(repoPath));
-		if (repoInfo.back().isGitRepository)
-		{
-			repoCount++;
-			if (repoInfo.back().uncommittedChanges ||
-				repoInfo.back().unstagedChanges ||
-				repoInfo.back().untrackedFiles)
-			{
-				if (needsSpace)
-					std::cout << "\n";
-
-				std::cout << repoInfo.back().name << "\n";
-				if (repoInfo.back().uncommittedChanges)
-					std::cout << "  -> Uncommitted changes\n";
-				if (repoInfo.back().unstagedChanges)
-					std::cout << "  -> Unstaged changes\n";
-				if (repoInfo.back().untrackedFiles)
-					std::cout << "  -> Untracked files\n";
-
-				std::cout << std::endl;
-				needsSpace = false;
-			}
-			else if (repoInfo.back().remotes.size() == 0)
-			{
-				std::cout << "No remotes for " << repoInfo.back().name << std::endl;
-				needsSpace = true;
-			}
-			else
-			{
-				std::string errorList;
-				if (gitIface.FetchAll(repoPath, errorList))
-				{
-					bool printedName(false);
-					unsigned int j, k;
-					for (j = 0; j < repoInfo.back().remotes.size(); j++)
-					{
-						for (k = 0; k < repoInfo.back().branches.size(); k++)
-						{
-							GitInterface::RepositoryStatus status =
-								GitInterface::CompareHeads(repoPath,
-								repoInfo.back(), repoInfo.back().remotes[j].name,
-								repoInfo.back().branches[k].name);
-
-							if (status != GitInterface::StatusUpToDate)
-							{
-								if (!printedName)
-								{
-									if (needsSpace)
-										std::cout << "\n";
-									std::cout << repoInfo.back().name;
-									printedName = true;
-								}
-									
-								std::cout << "\n ==> "
-									<< repoInfo.back().remotes[j].name
-									<< ":" << repoInfo.back().branches[k].name;
-
-								if (status == GitInterface::StatusLocalAhead ||
-									status == GitInterface::StatusRemoteMissingBranch)
-								{
-									if (gitIface.PushToRemote(repoPath,
-										repoInfo.back().remotes[j].name,
-										repoInfo.back().branches[k].name))
-										std::cout << " is now up-to-date";
-									else
-										std::cout << " push failed";
-								}
-								else if (status == GitInterface::StatusRemoteAhead)
-								{
-									// if (ff possible)
-									// merge
-									// else
-									// See:  http://stackoverflow.com/questions/15316601/in-what-cases-could-git-pull-be-harmful
-									std::cout << " has diverged from remote and requires user action";
-								}
-								else if (status == GitInterface::StatusLocalMissingBranch)
-								{
-									std::cout << " branch does not exist locally";
-								}
-
-								
-							}
-						}
-					}
-
-					if (printedName)
-					{
-						std::cout << "\n" << std::endl;
-						needsSpace = false;
-					}
-				}
-				else
-				{
-					if (needsSpace)
-						std::cout << "\n";
-
-					std::cout << repoInfo.back().name << "\n";
-					std::cout << errorList << std::endl;
-					needsSpace = false;
-				}
-			}
+			return;
 		}
-		else
+		else if (result.type == ScanEngine::Result::TypeNotRepository)
 		{
 			nonRepoCount++;
-			/*std::cout << repoInfo.back().name << " is not a git repository" << std::endl;
-			needsSpace = true;*/
+			return;
 		}
-	}
 
-	if (repoCount == 0)
+		repoCount++;
+		if (watch)
+			repoPaths.push_back(result.path);
+
+		if (result.output.empty())
+			return;
+
+		if (result.separate && needsSpace)
+			writer.Write("\n");
+		writer.Write(result.output);
+		needsSpace = result.needsSpaceAfter;
+	};
+
+	CheckSettings settings;
+	settings.fetch = true;
+	settings.format = format;
+	ScanEngine engine(jobCount, [&](const std::string& repoPath,
+		ScanEngine::Result& result)
+	{
+		jobLimiter.Acquire();
+		CheckRepository(gitIface, jobLimiter, settings, repoPath, result);
+		jobLimiter.Release();
+	}, emit, [&writer]()
+	{
+		writer.Flush();
+	});
+
+	// Checking starts as soon as the first directory is found.  The finder
+	// holds its lock while reporting, so when Enqueue blocks on a full window,
+	// every discovery thread waits until results are written.
+	RepositoryFinder finder(jobCount, searchDepth, [&engine](const std::string& path)
+	{
+		engine.Enqueue(path);
+	});
+	finder.Search(searchPath);
+	engine.Finish();
+
+	if (cache && !cache->Save())
+		std::cerr << "Failed to write cache file '" << cacheFileName << "'" << std::endl;
+	if (!traceFileName.empty() && !TraceRecorder::Write(traceFileName))
+		std::cerr << "Failed to write trace file '" << traceFileName << "'" << std::endl;
+
+	if (format == FormatJsonLines)
 	{
+		std::ostringstream summary;
+		summary << "{\"type\":\"summary\",\"repositories\":" << repoCount
+			<< ",\"skipped\":" << nonRepoCount << ",\"ignored\":" << ignoreCount << "}\n";
+		writer.Write(summary.str());
+		writer.Flush();
+	}
+	else if (repoCount == 0)
+	{
+		writer.Flush();
 		std::cout << "Failed to find any git repositories under '" << searchPath << "'" << std::endl;
+		PerformanceStats::Print(std::cerr);
 		return 0;
 	}
+	else
+	{
+		writer.Flush();
+		std::cout << "\nChecked " << repoCount << " git repositories" << std::endl;
+		std::cout << "Skipped " << nonRepoCount << " directories which did not contain repositories" << std::endl;
+		std::cout << "Ignored " << ignoreCount << " directories" << std::endl;
+	}
+	PerformanceStats::Print(std::cerr);
 
-	std::cout << "\nChecked " << repoCount << " git repositories" << std::endl;
-	std::cout << "Skipped " << nonRepoCount << " directories which did not contain repositories" << std::endl;
-	std::cout << "Ignored " << ignoreCount << " directories" << std::endl;
+	if (watch)
+		return WatchRepositories(gitIface, jobLimiter, jobCount, format, repoPaths,
+			cache.get(), traceFileName, writer) ? 0 : 1;
 
 	return 0;
 }
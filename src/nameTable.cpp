@@ -0,0 +1,41 @@
+// File:  nameTable.cpp
+// Date:  10/18/2026
+// Auth:  agent
+// Desc:  Run-wide table of branch and remote names.
+
+// Standard C++ headers
+#include <unordered_set>
+#include <mutex>
+
+// Local headers
+#include "nameTable.h"
+
+namespace
+{
+
+// Elements of an unordered_set never move, so pointers to them stay valid
+std::mutex& GetMutex()
+{
+	static std::mutex mutex;
+	return mutex;
+}
+
+std::unordered_set<std::string>& GetNames()
+{
+	static std::unordered_set<std::string> names;
+	return names;
+}
+
+}
+
+NameTable::Name::Name()
+{
+	static const Name empty(Intern(std::string()));
+	value = empty.value;
+}
+
+NameTable::Name NameTable::Intern(const std::string& name)
+{
+	std::lock_guard<std::mutex> lock(GetMutex());
+	return Name(&*GetNames().insert(name).first);
+}
@@ -0,0 +1,40 @@
+// File:  nameTable.h
+// Date:  10/18/2026
+// Auth:  agent
+// Desc:  Keeps one copy of each branch and remote name for the whole run.
+//        The same few names (master, main, origin, ...) appear in nearly
+//        every repository, so each one is stored once and referred to by
+//        pointer.
+
+#ifndef NAME_TABLE_H_
+#define NAME_TABLE_H_
+
+// Standard C++ headers
+#include <string>
+
+class NameTable
+{
+public:
+	class Name
+	{
+	public:
+		Name();
+
+		const std::string& Get() const { return *value; }
+		operator const std::string&() const { return *value; }
+
+		bool operator==(const Name& other) const { return value == other.value; }
+		bool operator==(const std::string& other) const { return *value == other; }
+
+	private:
+		friend class NameTable;
+		explicit Name(const std::string* value) : value(value) {}
+
+		const std::string* value;// Owned by the table and never released
+	};
+
+	// Safe to call from any thread
+	static Name Intern(const std::string& name);
+};
+
+#endif// NAME_TABLE_H_
@@ -0,0 +1,31 @@
+// File:  objectId.cpp
+// Date:  10/18/2026
+// Auth:  agent
+// Desc:  Fixed-size git object ID.
+
+// Local headers
+#include "objectId.h"
+#include "objectStore.h"
+
+ObjectId ObjectId::FromHex(const std::string& hex)
+{
+	ObjectId id;
+	const std::string raw(ObjectStore::FromHex(hex));
+	if (raw.length() == 20 || raw.length() == sizeof(id.bytes))
+	{
+		memcpy(id.bytes, raw.data(), raw.length());
+		id.length = static_cast<unsigned char>(raw.length());
+	}
+
+	return id;
+}
+
+std::string ObjectId::ToHex() const
+{
+	return ObjectStore::ToHex(GetRaw());
+}
+
+std::string ObjectId::GetRaw() const
+{
+	return std::string(reinterpret_cast<const char*>(bytes), length);
+}
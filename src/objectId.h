@@ -0,0 +1,39 @@
+// File:  objectId.h
+// Date:  10/18/2026
+// Auth:  agent
+// Desc:  Fixed-size git object ID (SHA-1 or SHA-256), so that holding one
+//        doesn't need a heap allocation for its hex form.
+
+#ifndef OBJECT_ID_H_
+#define OBJECT_ID_H_
+
+// Standard C++ headers
+#include <string>
+#include <cstring>
+
+class ObjectId
+{
+public:
+	ObjectId() : length(0) {}
+
+	// Empty (null) if the string isn't a SHA-1 or SHA-256 in lower case hex
+	static ObjectId FromHex(const std::string& hex);
+
+	std::string ToHex() const;
+	std::string GetRaw() const;
+
+	bool IsNull() const { return length == 0; }
+
+	bool operator==(const ObjectId& other) const
+	{
+		return length == other.length && memcmp(bytes, other.bytes, length) == 0;
+	}
+
+	bool operator!=(const ObjectId& other) const { return !(*this == other); }
+
+private:
+	unsigned char bytes[32];
+	unsigned char length;
+};
+
+#endif// OBJECT_ID_H_
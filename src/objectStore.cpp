@@ -0,0 +1,600 @@
+// File:  objectStore.cpp
+// Date:  10/18/2026
+// Auth:  agent
+// Desc:  Reads objects from a repository's object database.
+
+// Standard C/C++ headers
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+// Windows headers
+#include "windirent.h"// Local, but 3rd party
+#else
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <zlib.h>
+#endif
+
+// Local headers
+#include "objectStore.h"
+
+ObjectStore::ObjectStore(const std::string& commonDirectory) : packsLoaded(false)
+{
+	objectDirectories.push_back(commonDirectory + "objects/");
+
+	// Objects borrowed from other repositories (e.g. clone --reference)
+	std::ifstream alternates((objectDirectories.front() + "info/alternates").c_str());
+	std::string line;
+	while (std::getline(alternates, line))
+	{
+		if (line.empty() || line[0] == '#')
+			continue;
+		else if (line[0] != '/')
+			line = objectDirectories.front() + line;
+
+		if (line.back() != '/')
+			line.append("/");
+		objectDirectories.push_back(line);
+	}
+}
+
+ObjectStore::~ObjectStore()
+{
+	unsigned int i;
+	for (i = 0; i < packs.size(); i++)
+	{
+		UnmapFile(packs[i].index, packs[i].indexSize);
+		UnmapFile(packs[i].data, packs[i].dataSize);
+	}
+}
+
+bool ObjectStore::Read(const std::string& objectId, Type& type, std::string& contents)
+{
+	return Find(objectId, type, contents, 0);
+}
+
+bool ObjectStore::Find(const std::string& objectId, Type& type,
+	std::string& contents, const unsigned int& depth)
+{
+	if (!packsLoaded)
+		LoadPacks();
+
+	// Most objects are packed, so look there first
+	unsigned int i;
+	for (i = 0; i < packs.size(); i++)
+	{
+		uint64_t offset;
+		if (FindInPack(packs[i], objectId, offset))
+			return ReadPacked(packs[i], offset, type, contents, depth);
+	}
+
+	for (i = 0; i < objectDirectories.size(); i++)
+	{
+		if (ReadLoose(objectDirectories[i], objectId, type, contents))
+			return true;
+	}
+
+	return false;
+}
+
+bool ObjectStore::ReadLoose(const std::string& directory, const std::string& objectId,
+	Type& type, std::string& contents) const
+{
+	const std::string hex(ToHex(objectId));
+	if (hex.length() < 3)
+		return false;
+
+	std::ifstream file((directory + hex.substr(0, 2) + "/" + hex.substr(2)).c_str(),
+		std::ios::binary);
+	if (!file.is_open())
+		return false;
+
+	std::ostringstream ss;
+	ss << file.rdbuf();
+	std::string object;
+	if (!Inflate(ss.str(), object))
+		return false;
+
+	// The header is "<type> <size>" followed by a NUL
+	const size_t space(object.find(' '));
+	const size_t nul(object.find('\0'));
+	if (space == std::string::npos || nul == std::string::npos || space > nul)
+		return false;
+
+	type = GetType(object.substr(0, space));
+	const std::string sizeString(object.substr(space + 1, nul - space - 1));
+	char* end;
+	const unsigned long long size(strtoull(sizeString.c_str(), &end, 10));
+	if (type == TypeUnknown || sizeString.empty() || *end != '\0' ||
+		size != object.length() - nul - 1)
+		return false;
+
+	contents = object.substr(nul + 1);
+	return true;
+}
+
+void ObjectStore::LoadPacks()
+{
+	packsLoaded = true;
+	const std::string indexExtension(".idx");
+	unsigned int i;
+	for (i = 0; i < objectDirectories.size(); i++)
+	{
+		const std::string packDirectory(objectDirectories[i] + "pack/");
+		DIR *dp(opendir(packDirectory.c_str()));
+		if (!dp)
+			continue;
+
+		dirent *d;
+		while ((d = readdir(dp)) != NULL)
+		{
+			const std::string name(d->d_name);
+			if (name.length() <= indexExtension.length() ||
+				name.compare(name.length() - indexExtension.length(),
+				indexExtension.length(), indexExtension) != 0)
+				continue;
+
+			Pack pack;
+			if (LoadPack(packDirectory + name, pack))
+				packs.push_back(pack);
+		}
+
+		closedir(dp);
+	}
+}
+
+bool ObjectStore::LoadPack(const std::string& indexFileName, Pack& pack)
+{
+	// Version 2 index:  magic, version, 256 entry fan-out table, sorted IDs,
+	// CRCs, 31-bit offsets, 64-bit offsets, pack checksum, index checksum
+	const unsigned char indexMagic[4] = { 0xff, 't', 'O', 'c' };
+	const size_t headerSize(8 + 256 * 4);
+	pack.index = MapFile(indexFileName, pack.indexSize);
+	if (!pack.index)
+		return false;
+	else if (pack.indexSize < headerSize + 40 ||
+		memcmp(pack.index, indexMagic, sizeof(indexMagic)) != 0 ||
+		ReadBigEndian32(pack.index + 4) != 2)
+	{
+		UnmapFile(pack.index, pack.indexSize);
+		return false;
+	}
+
+	pack.objectCount = ReadBigEndian32(pack.index + headerSize - 4);
+	if (headerSize + static_cast<uint64_t>(pack.objectCount) * 28 + 40 > pack.indexSize)
+	{
+		UnmapFile(pack.index, pack.indexSize);
+		return false;
+	}
+
+	const std::string packFileName(indexFileName.substr(0,
+		indexFileName.length() - 4) + ".pack");
+	pack.data = MapFile(packFileName, pack.dataSize);
+	if (!pack.data || pack.dataSize < 12 + 20 || memcmp(pack.data, "PACK", 4) != 0)
+	{
+		UnmapFile(pack.index, pack.indexSize);
+		UnmapFile(pack.data, pack.dataSize);
+		return false;
+	}
+
+	return true;
+}
+
+bool ObjectStore::FindInPack(const Pack& pack, const std::string& objectId,
+	uint64_t& offset)
+{
+	const size_t idLength(20);
+	if (objectId.length() != idLength)
+		return false;
+
+	const unsigned char* fanOut(pack.index + 8);
+	const unsigned char* ids(fanOut + 256 * 4);
+	const unsigned char first(static_cast<unsigned char>(objectId[0]));
+	uint32_t low(first == 0 ? 0 : ReadBigEndian32(fanOut + 4 * (first - 1)));
+	uint32_t high(ReadBigEndian32(fanOut + 4 * first));
+	if (high > pack.objectCount)
+		return false;
+
+	while (low < high)
+	{
+		const uint32_t middle(low + (high - low) / 2);
+		const int comparison(memcmp(ids + middle * idLength, objectId.data(), idLength));
+		if (comparison < 0)
+			low = middle + 1;
+		else if (comparison > 0)
+			high = middle;
+		else
+		{
+			const unsigned char* offsets(ids + pack.objectCount * (idLength + 4));
+			offset = ReadBigEndian32(offsets + 4 * middle);
+			if ((offset & 0x80000000) == 0)
+				return true;
+
+			// Packs over 2 GB keep large offsets in a separate table
+			const uint64_t largeIndex(offset & 0x7fffffff);
+			const unsigned char* largeOffsets(offsets + 4 * pack.objectCount);
+			if (largeOffsets + 8 * (largeIndex + 1) > pack.index + pack.indexSize - 40)
+				return false;
+
+			offset = (static_cast<uint64_t>(ReadBigEndian32(largeOffsets + 8 * largeIndex)) << 32) |
+				ReadBigEndian32(largeOffsets + 8 * largeIndex + 4);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool ObjectStore::ReadPacked(const Pack& pack, uint64_t offset, Type& type,
+	std::string& contents, const unsigned int& depth)
+{
+	// Deltas are collected while following the chain back to a whole
+	// object, then applied starting from the one nearest the base
+	const size_t end(pack.dataSize - 20);// Trailing checksum
+	const size_t maxChainLength(10000);// Only reachable through a corrupt pack
+	std::vector<std::string> deltas;
+	std::string base;
+	while (true)
+	{
+		if (offset < 12 || offset >= end)
+			return false;
+
+		// Type and inflated size, seven bits at a time after the first four
+		size_t position(offset);
+		unsigned char c(pack.data[position++]);
+		const unsigned int packType((c >> 4) & 0x7);
+		uint64_t size(c & 0x0f);
+		unsigned int shift(4);
+		while ((c & 0x80) != 0)
+		{
+			if (position >= end || shift > 57)
+				return false;
+			c = pack.data[position++];
+			size |= static_cast<uint64_t>(c & 0x7f) << shift;
+			shift += 7;
+		}
+
+		const unsigned int offsetDelta(6), referenceDelta(7);
+		if (packType >= TypeCommit && packType <= TypeTag)
+		{
+			if (!Inflate(pack.data + position, end - position, size, base))
+				return false;
+			type = static_cast<Type>(packType);
+			break;
+		}
+		else if (packType == offsetDelta)
+		{
+			if (position >= end)
+				return false;
+			c = pack.data[position++];
+			uint64_t distance(c & 0x7f);
+			while ((c & 0x80) != 0)
+			{
+				if (position >= end || distance > (UINT64_MAX >> 8))
+					return false;
+				c = pack.data[position++];
+				distance = ((distance + 1) << 7) | (c & 0x7f);
+			}
+
+			deltas.push_back(std::string());
+			if (distance == 0 || distance > offset ||
+				!Inflate(pack.data + position, end - position, size, deltas.back()))
+				return false;
+			offset -= distance;
+		}
+		else if (packType == referenceDelta)
+		{
+			const size_t idLength(20);
+			const unsigned int maxDepth(8);
+			if (position + idLength > end || depth >= maxDepth ||
+				deltas.size() >= maxChainLength)
+				return false;
+
+			const std::string baseId(reinterpret_cast<const char*>(pack.data + position), idLength);
+			deltas.push_back(std::string());
+			if (!Inflate(pack.data + position + idLength, end - position - idLength,
+				size, deltas.back()))
+				return false;
+
+			// The base is almost always in the same pack; anywhere else
+			// (e.g. a thin pack that was completed) costs a nested read
+			if (!FindInPack(pack, baseId, offset))
+			{
+				if (!Find(baseId, type, base, depth + 1))
+					return false;
+				break;
+			}
+		}
+		else
+			return false;
+	}
+
+	std::string result;
+	while (!deltas.empty())
+	{
+		if (!ApplyDelta(base, deltas.back(), result))
+			return false;
+		base.swap(result);
+		deltas.pop_back();
+	}
+
+	contents.swap(base);
+	return true;
+}
+
+bool ObjectStore::ApplyDelta(const std::string& base, const std::string& delta,
+	std::string& result)
+{
+	size_t position(0);
+	auto readSize = [&delta, &position](uint64_t& size)
+	{
+		size = 0;
+		unsigned int shift(0);
+		unsigned char c;
+		do
+		{
+			if (position >= delta.length() || shift > 57)
+				return false;
+			c = static_cast<unsigned char>(delta[position++]);
+			size |= static_cast<uint64_t>(c & 0x7f) << shift;
+			shift += 7;
+		} while ((c & 0x80) != 0);
+		return true;
+	};
+
+	uint64_t baseSize, resultSize;
+	if (!readSize(baseSize) || !readSize(resultSize) || baseSize != base.length())
+		return false;
+
+	// Each instruction either copies a range of the base or inserts the
+	// bytes that follow it
+	result.clear();
+	result.reserve(resultSize);
+	while (position < delta.length())
+	{
+		const unsigned char instruction(static_cast<unsigned char>(delta[position++]));
+		if ((instruction & 0x80) != 0)
+		{
+			uint64_t copyOffset(0), copySize(0);
+			unsigned int i;
+			for (i = 0; i < 7; i++)
+			{
+				if ((instruction & (1 << i)) == 0)
+					continue;
+				else if (position >= delta.length())
+					return false;
+
+				const uint64_t value(static_cast<unsigned char>(delta[position++]));
+				if (i < 4)
+					copyOffset |= value << (8 * i);
+				else
+					copySize |= value << (8 * (i - 4));
+			}
+
+			if (copySize == 0)
+				copySize = 0x10000;
+			if (copyOffset + copySize > base.length())
+				return false;
+			result.append(base, copyOffset, copySize);
+		}
+		else if (instruction != 0)
+		{
+			if (position + instruction > delta.length())
+				return false;
+			result.append(delta, position, instruction);
+			position += instruction;
+		}
+		else
+			return false;
+	}
+
+	return result.length() == resultSize;
+}
+
+bool ObjectStore::GetCommitTree(const std::string& commitId, std::string& treeId)
+{
+	Type type;
+	std::string commit;
+	if (!Read(commitId, type, commit) || type != TypeCommit)
+		return false;
+
+	// The tree is always the first header line
+	const std::string treePrefix("tree ");
+	const size_t newline(commit.find('\n'));
+	if (commit.compare(0, treePrefix.length(), treePrefix) != 0 ||
+		newline == std::string::npos)
+		return false;
+
+	treeId = FromHex(commit.substr(treePrefix.length(), newline - treePrefix.length()));
+	return treeId.length() == commitId.length();
+}
+
+std::string ObjectStore::ToHex(const std::string& objectId)
+{
+	const char digits[] = "0123456789abcdef";
+	std::string hex;
+	hex.reserve(objectId.length() * 2);
+	unsigned int i;
+	for (i = 0; i < objectId.length(); i++)
+	{
+		const unsigned char c(static_cast<unsigned char>(objectId[i]));
+		hex.push_back(digits[c >> 4]);
+		hex.push_back(digits[c & 0xf]);
+	}
+
+	return hex;
+}
+
+std::string ObjectStore::FromHex(const std::string& hex)
+{
+	if (hex.length() % 2 != 0)
+		return std::string();
+
+	std::string objectId;
+	objectId.reserve(hex.length() / 2);
+	unsigned int i;
+	for (i = 0; i < hex.length(); i += 2)
+	{
+		int value(0);
+		unsigned int j;
+		for (j = i; j < i + 2; j++)
+		{
+			value <<= 4;
+			if (hex[j] >= '0' && hex[j] <= '9')
+				value |= hex[j] - '0';
+			else if (hex[j] >= 'a' && hex[j] <= 'f')
+				value |= hex[j] - 'a' + 10;
+			else
+				return std::string();
+		}
+
+		objectId.push_back(static_cast<char>(value));
+	}
+
+	return objectId;
+}
+
+#ifdef _WIN32
+
+const unsigned char* ObjectStore::MapFile(const std::string& fileName, size_t& size)
+{
+	std::ifstream file(fileName.c_str(), std::ios::binary);
+	if (!file.is_open())
+		return NULL;
+
+	std::ostringstream ss;
+	ss << file.rdbuf();
+	const std::string contents(ss.str());
+	unsigned char* buffer(new unsigned char[contents.length()]);
+	memcpy(buffer, contents.c_str(), contents.length());
+	size = contents.length();
+	return buffer;
+}
+
+void ObjectStore::UnmapFile(const unsigned char* data, const size_t&)
+{
+	delete [] data;
+}
+
+bool ObjectStore::Inflate(const std::string&, std::string&)
+{
+	return false;
+}
+
+bool ObjectStore::Inflate(const unsigned char*, const size_t&, const size_t&, std::string&)
+{
+	return false;
+}
+
+#else
+
+const unsigned char* ObjectStore::MapFile(const std::string& fileName, size_t& size)
+{
+	const int fd(open(fileName.c_str(), O_RDONLY | O_CLOEXEC));
+	if (fd < 0)
+		return NULL;
+
+	struct stat info;
+	if (fstat(fd, &info) != 0 || info.st_size == 0)
+	{
+		close(fd);
+		return NULL;
+	}
+
+	void* data(mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0));
+	close(fd);
+	if (data == MAP_FAILED)
+		return NULL;
+
+	size = info.st_size;
+	return static_cast<const unsigned char*>(data);
+}
+
+void ObjectStore::UnmapFile(const unsigned char* data, const size_t& size)
+{
+	if (data)
+		munmap(const_cast<unsigned char*>(data), size);
+}
+
+bool ObjectStore::Inflate(const std::string& compressed, std::string& contents)
+{
+	z_stream stream = z_stream();
+	if (inflateInit(&stream) != Z_OK)
+		return false;
+
+	stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(compressed.data()));
+	stream.avail_in = static_cast<uInt>(compressed.length());
+
+	contents.clear();
+	char buffer[16384];
+	int result;
+	do
+	{
+		stream.next_out = reinterpret_cast<Bytef*>(buffer);
+		stream.avail_out = sizeof(buffer);
+		result = inflate(&stream, Z_NO_FLUSH);
+		contents.append(buffer, sizeof(buffer) - stream.avail_out);
+	} while (result == Z_OK);
+
+	inflateEnd(&stream);
+	return result == Z_STREAM_END;
+}
+
+bool ObjectStore::Inflate(const unsigned char* compressed, const size_t& compressedSize,
+	const size_t& expectedSize, std::string& contents)
+{
+	// Packed data isn't delimited, but the inflated size is known
+	z_stream stream = z_stream();
+	if (inflateInit(&stream) != Z_OK)
+		return false;
+
+	contents.resize(expectedSize);
+	stream.next_in = const_cast<Bytef*>(compressed);
+	stream.avail_in = static_cast<uInt>(std::min(compressedSize,
+		static_cast<size_t>(UINT32_MAX)));
+	stream.next_out = reinterpret_cast<Bytef*>(&contents[0]);
+	stream.avail_out = static_cast<uInt>(expectedSize);
+
+	// Z_BUF_ERROR comes back for an empty object, where there's no room for
+	// output until the end of the stream has been seen
+	unsigned char empty;
+	if (expectedSize == 0)
+	{
+		stream.next_out = &empty;
+		stream.avail_out = 1;
+	}
+
+	const int result(inflate(&stream, Z_FINISH));
+	const bool complete(result == Z_STREAM_END && stream.total_out == expectedSize);
+	inflateEnd(&stream);
+	return complete;
+}
+
+#endif
+
+uint32_t ObjectStore::ReadBigEndian32(const unsigned char* p)
+{
+	return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+		(static_cast<uint32_t>(p[2]) << 8) | static_cast<uint32_t>(p[3]);
+}
+
+ObjectStore::Type ObjectStore::GetType(const std::string& name)
+{
+	if (name.compare("commit") == 0)
+		return TypeCommit;
+	else if (name.compare("tree") == 0)
+		return TypeTree;
+	else if (name.compare("blob") == 0)
+		return TypeBlob;
+	else if (name.compare("tag") == 0)
+		return TypeTag;
+
+	return TypeUnknown;
+}
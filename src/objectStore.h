@@ -0,0 +1,85 @@
+// File:  objectStore.h
+// Date:  10/18/2026
+// Auth:  agent
+// Desc:  Reads objects from a repository's object database (loose objects
+//        and packs, including alternates) without starting git.
+
+#ifndef OBJECT_STORE_H_
+#define OBJECT_STORE_H_
+
+// Standard C++ headers
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+class ObjectStore
+{
+public:
+	// Accepts the common git directory (the one containing objects/)
+	explicit ObjectStore(const std::string& commonDirectory);
+	~ObjectStore();
+
+	enum Type
+	{
+		TypeUnknown,
+		TypeCommit,
+		TypeTree,
+		TypeBlob,
+		TypeTag
+	};
+
+	// Object IDs are raw bytes; false if the object can't be found or read
+	bool Read(const std::string& objectId, Type& type, std::string& contents);
+
+	// Returns the ID of the tree that a commit records
+	bool GetCommitTree(const std::string& commitId, std::string& treeId);
+
+	static std::string ToHex(const std::string& objectId);
+	static std::string FromHex(const std::string& hex);
+
+	// Maps a whole file read-only (read into memory where mmap isn't
+	// available); NULL on failure
+	static const unsigned char* MapFile(const std::string& fileName, size_t& size);
+	static void UnmapFile(const unsigned char* data, const size_t& size);
+
+private:
+	std::vector<std::string> objectDirectories;// The first is the repository's own
+
+	struct Pack
+	{
+		const unsigned char* index;
+		size_t indexSize;
+		const unsigned char* data;
+		size_t dataSize;
+		uint32_t objectCount;
+	};
+
+	bool packsLoaded;
+	std::vector<Pack> packs;
+
+	void LoadPacks();
+	bool LoadPack(const std::string& indexFileName, Pack& pack);
+
+	bool Find(const std::string& objectId, Type& type, std::string& contents,
+		const unsigned int& depth);
+	bool ReadLoose(const std::string& directory, const std::string& objectId,
+		Type& type, std::string& contents) const;
+
+	static bool FindInPack(const Pack& pack, const std::string& objectId, uint64_t& offset);
+	bool ReadPacked(const Pack& pack, uint64_t offset, Type& type,
+		std::string& contents, const unsigned int& depth);
+	static bool ApplyDelta(const std::string& base, const std::string& delta,
+		std::string& result);
+
+	static bool Inflate(const std::string& compressed, std::string& contents);
+	static bool Inflate(const unsigned char* compressed, const size_t& compressedSize,
+		const size_t& expectedSize, std::string& contents);
+	static Type GetType(const std::string& name);
+	static uint32_t ReadBigEndian32(const unsigned char* p);
+
+	ObjectStore(const ObjectStore&);
+	ObjectStore& operator=(const ObjectStore&);
+};
+
+#endif// OBJECT_STORE_H_
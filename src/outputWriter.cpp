@@ -0,0 +1,44 @@
+// File:  outputWriter.cpp
+// Date:  10/18/2026
+// Auth:  agent
+// Desc:  Buffered writer for stdout.
+
+// Standard C++ headers
+#include <iostream>
+
+// Local headers
+#include "outputWriter.h"
+
+const size_t OutputWriter::bufferSize(64 * 1024);
+
+OutputWriter::OutputWriter()
+{
+	buffer.reserve(bufferSize);
+}
+
+OutputWriter::~OutputWriter()
+{
+	Flush();
+}
+
+void OutputWriter::Write(const std::string& s)
+{
+	if (buffer.length() + s.length() > bufferSize)
+		Flush();
+
+	if (s.length() >= bufferSize)
+		std::cout.write(s.c_str(), s.length());
+	else
+		buffer.append(s);
+}
+
+void OutputWriter::Flush()
+{
+	if (!buffer.empty())
+	{
+		std::cout.write(buffer.c_str(), buffer.length());
+		buffer.clear();
+	}
+
+	std::cout.flush();
+}
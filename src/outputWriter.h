@@ -0,0 +1,29 @@
+// File:  outputWriter.h
+// Date:  10/18/2026
+// Auth:  agent
+// Desc:  Buffers output to stdout so results arriving together are written
+//        together, instead of flushing after every line.
+
+#ifndef OUTPUT_WRITER_H_
+#define OUTPUT_WRITER_H_
+
+// Standard C++ headers
+#include <string>
+
+class OutputWriter
+{
+public:
+	OutputWriter();
+	~OutputWriter();
+
+	void Write(const std::string& s);
+
+	// Call whenever no more output is expected soon
+	void Flush();
+
+private:
+	static const size_t bufferSize;
+	std::string buffer;
+};
+
+#endif// OUTPUT_WRITER_H_
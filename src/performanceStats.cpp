@@ -0,0 +1,176 @@
+// File:  performanceStats.cpp
+// Date:  10/18/2026
+// Auth:  agent
+// Desc:  Collects time, process count and memory use for each phase of a run.
+
+// Standard C/C++ headers
+#include <atomic>
+#include <iomanip>
+#include <fstream>
+
+#ifndef _WIN32
+#include <unistd.h>
+#include <sys/resource.h>
+#endif
+
+// Local headers
+#include "performanceStats.h"
+
+bool PerformanceStats::enabled(false);
+std::chrono::steady_clock::time_point PerformanceStats::startTime;
+
+namespace
+{
+
+struct PhaseTotals
+{
+	std::atomic<unsigned long long> calls;
+	std::atomic<unsigned long long> nanoseconds;
+	std::atomic<unsigned long long> processes;
+	std::atomic<long> residentSizeGrowth;// Largest increase during one call [kB]
+};
+
+PhaseTotals totals[PerformanceStats::PhaseCount];
+std::atomic<unsigned long long> unattributedProcesses(0);
+
+thread_local PerformanceStats::Phase currentPhase(PerformanceStats::PhaseNone);
+
+}
+
+void PerformanceStats::Enable()
+{
+	enabled = true;
+	startTime = std::chrono::steady_clock::now();
+}
+
+PerformanceStats::PhaseTimer::PhaseTimer(const Phase& phase) : phase(phase),
+	previousPhase(currentPhase), start(std::chrono::steady_clock::now()),
+	startResidentSize(enabled ? GetResidentSize() : 0), span("phase", GetName(phase))
+{
+	currentPhase = phase;
+}
+
+PerformanceStats::PhaseTimer::~PhaseTimer()
+{
+	currentPhase = previousPhase;
+	if (!enabled)
+		return;
+
+	totals[phase].calls++;
+	totals[phase].nanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now() - start).count();
+
+	// Other threads allocate at the same time, so with more than one job
+	// this is an upper bound on what the phase itself used
+	const long growth(GetResidentSize() - startResidentSize);
+	long previous(totals[phase].residentSizeGrowth);
+	while (growth > previous &&
+		!totals[phase].residentSizeGrowth.compare_exchange_weak(previous, growth))
+	{
+	}
+}
+
+PerformanceStats::PhaseScope::PhaseScope(const Phase& phase)
+	: previousPhase(currentPhase)
+{
+	currentPhase = phase;
+}
+
+PerformanceStats::PhaseScope::~PhaseScope()
+{
+	currentPhase = previousPhase;
+}
+
+PerformanceStats::Phase PerformanceStats::GetCurrentPhase()
+{
+	return currentPhase;
+}
+
+void PerformanceStats::CountProcess()
+{
+	if (!enabled)
+		return;
+
+	if (currentPhase == PhaseNone)
+		unattributedProcesses++;
+	else
+		totals[currentPhase].processes++;
+}
+
+long PerformanceStats::GetResidentSize()
+{
+#ifdef __linux__
+	// Sizes are in pages:  total program size, then resident set size
+	std::ifstream statm("/proc/self/statm");
+	long size, resident;
+	if (!(statm >> size >> resident))
+		return 0;
+	return resident * (sysconf(_SC_PAGESIZE) / 1024);
+#else
+	return 0;
+#endif
+}
+
+long PerformanceStats::GetPeakResidentSize()
+{
+#ifdef _WIN32
+	return 0;
+#else
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+		return 0;
+#ifdef __APPLE__
+	return usage.ru_maxrss / 1024;// Reported in bytes
+#else
+	return usage.ru_maxrss;
+#endif
+#endif
+}
+
+const char* PerformanceStats::GetName(const Phase& phase)
+{
+	switch (phase)
+	{
+	case PhaseDiscovery:
+		return "discovery";
+	case PhaseStatus:
+		return "status";
+	case PhaseFetch:
+		return "fetch";
+	case PhaseCompare:
+		return "compare";
+	case PhasePush:
+		return "push";
+	default:
+		return "other";
+	}
+}
+
+void PerformanceStats::Print(std::ostream& out)
+{
+	if (!enabled)
+		return;
+
+	const double wallTime(std::chrono::duration<double>(
+		std::chrono::steady_clock::now() - startTime).count());
+
+	// Phases overlap when running with more than one job, so times are the
+	// sum over all threads rather than a share of the wall time
+	out << "\nPhase        Calls   Time [s]  Processes  Max RSS growth [kB]\n";
+	unsigned long long totalProcesses(unattributedProcesses);
+	int i;
+	for (i = 0; i < PhaseCount; i++)
+	{
+		out << std::left << std::setw(10) << GetName(static_cast<Phase>(i))
+			<< std::right << std::setw(8) << totals[i].calls
+			<< std::setw(11) << std::fixed << std::setprecision(3)
+			<< totals[i].nanoseconds * 1.0e-9
+			<< std::setw(11) << totals[i].processes
+			<< std::setw(21) << totals[i].residentSizeGrowth << "\n";
+		totalProcesses += totals[i].processes;
+	}
+
+	out << "\nWall time:      " << std::fixed << std::setprecision(3) << wallTime << " s\n"
+		<< "Processes:      " << totalProcesses << "\n"
+		<< "Peak RSS:       " << GetPeakResidentSize() << " kB" << std::endl;
+}
@@ -0,0 +1,82 @@
+// File:  performanceStats.h
+// Date:  10/18/2026
+// Auth:  agent
+// Desc:  Collects time, process count and memory use for each phase of a run.
+
+#ifndef PERFORMANCE_STATS_H_
+#define PERFORMANCE_STATS_H_
+
+// Standard C++ headers
+#include <ostream>
+#include <chrono>
+
+// Local headers
+#include "traceRecorder.h"
+
+class PerformanceStats
+{
+public:
+	enum Phase
+	{
+		PhaseNone = -1,
+		PhaseDiscovery,
+		PhaseStatus,
+		PhaseFetch,
+		PhaseCompare,
+		PhasePush,
+		PhaseCount
+	};
+
+	// Nothing is recorded unless enabled
+	static void Enable();
+	static bool IsEnabled() { return enabled; }
+
+	// Attributes time and processes started on this thread to a phase for the
+	// lifetime of the object (and records it as a trace span)
+	class PhaseTimer
+	{
+	public:
+		explicit PhaseTimer(const Phase& phase);
+		~PhaseTimer();
+
+	private:
+		const Phase phase;
+		const Phase previousPhase;
+		const std::chrono::steady_clock::time_point start;
+		const long startResidentSize;// [kB]
+		TraceRecorder::Span span;
+
+		PhaseTimer(const PhaseTimer&);
+		PhaseTimer& operator=(const PhaseTimer&);
+	};
+
+	// Attributes processes started on this thread to a phase for the lifetime
+	// of the object, without timing it (for work continued on another thread)
+	class PhaseScope
+	{
+	public:
+		explicit PhaseScope(const Phase& phase);
+		~PhaseScope();
+
+	private:
+		const Phase previousPhase;
+
+		PhaseScope(const PhaseScope&);
+		PhaseScope& operator=(const PhaseScope&);
+	};
+
+	static Phase GetCurrentPhase();
+	static void CountProcess();
+
+	static void Print(std::ostream& out);
+
+private:
+	static bool enabled;
+	static std::chrono::steady_clock::time_point startTime;
+
+	static long GetResidentSize();// [kB]
+	static long GetPeakResidentSize();// [kB]
+	static const char* GetName(const Phase& phase);
+};
+
+#endif// PERFORMANCE_STATS_H_
@@ -0,0 +1,329 @@
+// File:  processExecutor.cpp
+// Date:  10/18/2026
+// Auth:  agent
+// Desc:  Runs many child processes at once from a single epoll thread.
+
+// Standard C/C++ headers
+#include <cerrno>
+#include <cassert>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#endif
+
+// Local headers
+#include "processExecutor.h"
+
+#ifdef __linux__
+
+ProcessExecutor::ProcessExecutor() : stopping(false), nextId(0)
+{
+	epollFd = -1;
+	wakeFd = -1;
+}
+
+ProcessExecutor::~ProcessExecutor()
+{
+	if (thread.joinable())
+	{
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopping = true;
+		}
+
+		const uint64_t one(1);
+		if (write(wakeFd, &one, sizeof(one)) < 0)
+		{
+		}
+		thread.join();
+	}
+
+	if (epollFd >= 0)
+		close(epollFd);
+	if (wakeFd >= 0)
+		close(wakeFd);
+}
+
+bool ProcessExecutor::Start(const ShellInterface::ArgumentList& arguments,
+	const CompletionFunction& completion, const ShellInterface::Deadline& deadline,
+	const ShellInterface::RedirectFlags& f)
+{
+	std::unique_ptr<Child> child(new Child);
+	child->start = std::chrono::steady_clock::now();
+	child->phase = PerformanceStats::GetCurrentPhase();
+	if (TraceRecorder::IsEnabled())
+	{
+		std::string name, commandLine;
+		ShellInterface::DescribeCommand(arguments, name, commandLine);
+		child->span.reset(new TraceRecorder::Span("process", name));
+		child->span->AddArgument("command", commandLine);
+	}
+
+	if (!ShellInterface::StartProcess(arguments, f, child->process, deadline))
+		return false;
+
+	child->completion = completion;
+	if (child->process.stdOut >= 0)
+		fcntl(child->process.stdOut, F_SETFL, O_NONBLOCK);
+	if (child->process.stdErr >= 0)
+		fcntl(child->process.stdErr, F_SETFL, O_NONBLOCK);
+
+#ifdef SYS_pidfd_open
+	child->pidFd = syscall(SYS_pidfd_open, child->process.pid, 0);
+#endif
+
+	std::lock_guard<std::mutex> lock(mutex);
+
+	// The thread is only started once something needs it
+	if (!thread.joinable())
+	{
+		epollFd = epoll_create1(EPOLL_CLOEXEC);
+		wakeFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+		assert(epollFd >= 0 && wakeFd >= 0);
+
+		epoll_event event;
+		event.events = EPOLLIN;
+		event.data.u64 = 0;
+		epoll_ctl(epollFd, EPOLL_CTL_ADD, wakeFd, &event);
+		thread = std::thread(&ProcessExecutor::Run, this);
+	}
+
+	pending.push_back(std::move(child));
+	const uint64_t one(1);
+	if (write(wakeFd, &one, sizeof(one)) < 0)
+	{
+	}
+
+	return true;
+}
+
+void ProcessExecutor::Run()
+{
+	const int maxEvents(64);
+	epoll_event events[maxEvents];
+	while (true)
+	{
+		std::vector<std::unique_ptr<Child> > newChildren;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			newChildren.swap(pending);
+			if (stopping && newChildren.empty() && children.empty())
+				return;
+		}
+
+		unsigned int i;
+		for (i = 0; i < newChildren.size(); i++)
+			Register(newChildren[i]);
+
+		// Without pidfds there is no notification when a child exits after
+		// closing its output, so poll for those
+		bool polling(false);
+		int timeout(-1);
+		std::map<uint64_t, std::unique_ptr<Child> >::iterator it;
+		for (it = children.begin(); it != children.end(); ++it)
+		{
+			Child& child(*it->second);
+			if (child.pidFd < 0 && child.process.stdOut < 0 && child.process.stdErr < 0)
+				polling = true;
+
+			const int wait(ShellInterface::EnforceDeadline(child.process, child.result));
+			if (wait >= 0 && (timeout < 0 || wait < timeout))
+				timeout = wait;
+		}
+
+		if (polling && (timeout < 0 || timeout > 10))
+			timeout = 10;
+
+		const int count(epoll_wait(epollFd, events, maxEvents, timeout));
+		if (count < 0 && errno != EINTR)
+			break;
+
+		int j;
+		for (j = 0; j < count; j++)
+		{
+			if (events[j].data.u64 == 0)
+			{
+				uint64_t value;
+				if (read(wakeFd, &value, sizeof(value)) < 0)
+				{
+				}
+				continue;
+			}
+
+			HandleEvent(events[j].data.u64);
+		}
+
+		if (polling)
+		{
+			std::vector<uint64_t> ids;
+			for (it = children.begin(); it != children.end(); ++it)
+				ids.push_back(it->first);
+			for (i = 0; i < ids.size(); i++)
+				FinishIfDone(ids[i]);
+		}
+	}
+}
+
+void ProcessExecutor::Register(std::unique_ptr<Child>& child)
+{
+	// Event data holds the child's ID above the source of the event; zero is
+	// reserved for the wake-up eventfd
+	const uint64_t id(++nextId);
+	const int fds[3] = { child->process.stdOut, child->process.stdErr, child->pidFd };
+	const Source sources[3] = { SourceStdOut, SourceStdErr, SourcePidFd };
+	unsigned int i;
+	for (i = 0; i < 3; i++)
+	{
+		if (fds[i] < 0)
+			continue;
+
+		epoll_event event;
+		event.events = EPOLLIN;
+		event.data.u64 = (id << 2) | sources[i];
+		epoll_ctl(epollFd, EPOLL_CTL_ADD, fds[i], &event);
+	}
+
+	children[id].swap(child);
+	FinishIfDone(id);
+}
+
+void ProcessExecutor::HandleEvent(const uint64_t& data)
+{
+	const uint64_t id(data >> 2);
+	std::map<uint64_t, std::unique_ptr<Child> >::iterator it(children.find(id));
+	if (it == children.end())
+		return;
+
+	Child& child(*it->second);
+	const Source source(static_cast<Source>(data & 0x3));
+	if (source == SourcePidFd)
+	{
+		epoll_ctl(epollFd, EPOLL_CTL_DEL, child.pidFd, NULL);
+		close(child.pidFd);
+		child.pidFd = -1;
+		Reap(child);
+	}
+	else
+	{
+		int& fd(source == SourceStdOut ? child.process.stdOut : child.process.stdErr);
+		std::string& output(source == SourceStdOut ? child.result.stdOut : child.result.stdErr);
+		char buffer[65536];
+		const ssize_t count(read(fd, buffer, sizeof(buffer)));
+		if (count > 0)
+		{
+			output.append(buffer, count);
+			if (source == SourceStdOut)
+				child.result.stdOutBytes += count;
+		}
+		else if (count == 0 || (errno != EINTR && errno != EAGAIN))
+		{
+			epoll_ctl(epollFd, EPOLL_CTL_DEL, fd, NULL);
+			close(fd);
+			fd = -1;
+		}
+	}
+
+	FinishIfDone(id);
+}
+
+bool ProcessExecutor::Reap(Child& child)
+{
+	if (child.exited)
+		return true;
+
+	siginfo_t info;
+	info.si_pid = 0;
+	if (waitid(P_PID, child.process.pid, &info, WEXITED | WNOHANG | WNOWAIT) == 0 &&
+		info.si_pid == 0)
+		return false;
+	ShellInterface::KillRemainingGroup(child.process);
+
+	int status;
+	pid_t result;
+	while ((result = waitpid(child.process.pid, &status, WNOHANG)) < 0 &&
+		errno == EINTR)
+	{
+	}
+
+	if (result == 0)
+		return false;
+
+	child.exited = true;
+	child.process.pid = -1;
+	if (result < 0)
+		return true;
+
+	if (WIFEXITED(status))
+		child.result.exitCode = WEXITSTATUS(status);
+	else if (WIFSIGNALED(status))
+		child.result.exitCode = 128 + WTERMSIG(status);
+	child.result.started = true;
+
+	return true;
+}
+
+void ProcessExecutor::FinishIfDone(const uint64_t& id)
+{
+	std::map<uint64_t, std::unique_ptr<Child> >::iterator it(children.find(id));
+	assert(it != children.end());
+	Child& child(*it->second);
+
+	// Output may still be buffered after the child exits, and (without a
+	// pidfd) the child may still be running after closing its output
+	if (child.process.stdOut >= 0 || child.process.stdErr >= 0)
+		return;
+	if (child.pidFd >= 0 || !Reap(child))
+		return;
+
+	child.result.elapsedTime = std::chrono::duration<double>(
+		std::chrono::steady_clock::now() - child.start).count();
+	if (child.span)
+	{
+		child.span->AddArgument("exitCode", static_cast<long long>(child.result.exitCode));
+		child.span->AddArgument("stdOutBytes", static_cast<long long>(child.result.stdOutBytes));
+		child.span->AddArgument("stdErrBytes", static_cast<long long>(child.result.stdErr.length()));
+		if (child.result.timedOut)
+			child.span->AddArgument("timedOut", 1LL);
+	}
+
+	// Removed first so the completion function may start more children
+	std::unique_ptr<Child> finished(std::move(it->second));
+	children.erase(it);
+
+	// The span must be recorded before completion wakes whoever is waiting
+	finished->span.reset();
+	PerformanceStats::PhaseScope scope(finished->phase);
+	finished->completion(finished->result);
+}
+
+#else
+
+// Without epoll, children are run one at a time on the calling thread
+ProcessExecutor::ProcessExecutor()
+{
+}
+
+ProcessExecutor::~ProcessExecutor()
+{
+}
+
+bool ProcessExecutor::Start(const ShellInterface::ArgumentList& arguments,
+	const CompletionFunction& completion, const ShellInterface::Deadline& deadline,
+	const ShellInterface::RedirectFlags& f)
+{
+	ShellInterface shell;
+	shell.SetDeadline(deadline);
+	ShellInterface::ProcessResult result;
+	if (!shell.ExecuteCommand(arguments, result, f))
+		return false;
+
+	completion(result);
+	return true;
+}
+
+#endif
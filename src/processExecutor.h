@@ -0,0 +1,95 @@
+// File:  processExecutor.h
+// Date:  10/18/2026
+// Auth:  agent
+// Desc:  Runs many child processes at once from a single thread, which waits
+//        on all of their pipes (and pidfds) with epoll.
+
+#ifndef PROCESS_EXECUTOR_H_
+#define PROCESS_EXECUTOR_H_
+
+// Standard C++ headers
+#include <vector>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <functional>
+#include <chrono>
+#include <cstdint>
+
+// Local headers
+#include "shellInterface.h"
+#include "traceRecorder.h"
+#include "performanceStats.h"
+
+class ProcessExecutor
+{
+public:
+	ProcessExecutor();
+
+	// Waits for any children that are still running
+	~ProcessExecutor();
+
+	// Called on the executor's thread, so it must not block (starting another
+	// process is fine)
+	typedef std::function<void(const ShellInterface::ProcessResult& result)> CompletionFunction;
+
+	// Returns immediately; false if the child could not be started, in which
+	// case the completion function is never called
+	bool Start(const ShellInterface::ArgumentList& arguments,
+		const CompletionFunction& completion,
+		const ShellInterface::Deadline& deadline = ShellInterface::NoDeadline(),
+		const ShellInterface::RedirectFlags& f = ShellInterface::RedirectNone);
+
+private:
+#ifdef __linux__
+	struct Child
+	{
+		Child() : pidFd(-1), exited(false), phase(PerformanceStats::PhaseNone) {}
+
+		ShellInterface::ChildProcess process;
+		int pidFd;// Or -1 if the kernel doesn't support pidfds
+		bool exited;
+
+		ShellInterface::ProcessResult result;
+		CompletionFunction completion;
+		std::chrono::steady_clock::time_point start;
+		std::unique_ptr<TraceRecorder::Span> span;
+
+		// Phase of the thread that started the child, so that anything the
+		// completion function starts is counted against the same phase
+		PerformanceStats::Phase phase;
+	};
+
+	enum Source
+	{
+		SourceStdOut,
+		SourceStdErr,
+		SourcePidFd
+	};
+
+	int epollFd;
+	int wakeFd;
+	std::thread thread;
+
+	// Children are handed to the executor's thread through the pending list;
+	// after that only the executor's thread touches them
+	std::mutex mutex;
+	bool stopping;
+	std::vector<std::unique_ptr<Child> > pending;
+
+	uint64_t nextId;
+	std::map<uint64_t, std::unique_ptr<Child> > children;
+
+	void Run();
+	void Register(std::unique_ptr<Child>& child);
+	void HandleEvent(const uint64_t& data);
+	bool Reap(Child& child);
+	void FinishIfDone(const uint64_t& id);
+#endif
+
+	ProcessExecutor(const ProcessExecutor&);
+	ProcessExecutor& operator=(const ProcessExecutor&);
+};
+
+#endif// PROCESS_EXECUTOR_H_
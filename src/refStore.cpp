@@ -0,0 +1,273 @@
+// File:  refStore.cpp
+// Date:  10/18/2026
+// Auth:  agent
+// Desc:  Reads refs without starting git.
+
+// Standard C/C++ headers
+#include <fstream>
+#include <sstream>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+// Windows headers
+#include "windirent.h"// Local, but 3rd party
+#else
+#include <dirent.h>
+#endif
+
+// Local headers
+#include "refStore.h"
+#include "stringUtilities.h"
+
+bool RefStore::FindGitDirectory(const std::string& path,
+	std::string& gitDirectory, std::string& commonDirectory)
+{
+	std::string workTree(path);
+	if (workTree.back() != '/' && workTree.back() != '\\')
+		workTree.append("/");
+
+	gitDirectory = workTree + ".git";
+	struct stat info;
+	if (stat(gitDirectory.c_str(), &info) != 0)
+		return false;
+
+	if (!S_ISDIR(info.st_mode))
+	{
+		// Submodules and linked worktrees use a file containing "gitdir: <path>"
+		std::string contents;
+		const std::string gitDirPrefix("gitdir:");
+		if (!ReadFile(gitDirectory, contents) ||
+			contents.compare(0, gitDirPrefix.length(), gitDirPrefix) != 0)
+			return false;
+
+		gitDirectory = Trim(contents.substr(gitDirPrefix.length()));
+		if (gitDirectory.empty())
+			return false;
+		else if (gitDirectory[0] != '/' &&
+			!(gitDirectory.length() > 1 && gitDirectory[1] == ':'))
+			gitDirectory = workTree + gitDirectory;
+	}
+
+	if (gitDirectory.back() != '/')
+		gitDirectory.append("/");
+
+	// Linked worktrees keep shared refs in the main repository
+	commonDirectory = gitDirectory;
+	std::string commonDir;
+	if (ReadFile(gitDirectory + "commondir", commonDir))
+	{
+		commonDir = Trim(commonDir);
+		if (!commonDir.empty() && commonDir[0] == '/')
+			commonDirectory = commonDir;
+		else
+			commonDirectory = gitDirectory + commonDir;
+
+		if (commonDirectory.back() != '/')
+			commonDirectory.append("/");
+	}
+
+	return true;
+}
+
+bool RefStore::Read(const std::string& path)
+{
+	refs.clear();
+	symbolicRefs.clear();
+
+	if (!FindGitDirectory(path, gitDirectory, commonDirectory))
+		return false;
+
+	// We don't understand the reftable format - let git handle it
+	struct stat info;
+	if (stat((commonDirectory + "reftable").c_str(), &info) == 0)
+		return false;
+
+	if (!ReadLooseRef(gitDirectory + "HEAD", "HEAD"))
+		return false;
+
+	// Loose refs take precedence over packed refs, so read them last
+	if (!ReadPackedRefs(commonDirectory + "packed-refs"))
+		return false;
+
+	return ReadLooseRefs(commonDirectory + "refs/", "refs/");
+}
+
+bool RefStore::ReadSnapshot(const std::string& forEachRefOutput)
+{
+	refs.clear();
+	symbolicRefs.clear();
+
+	std::istringstream ss(forEachRefOutput);
+	std::string line;
+	while (std::getline(ss, line))
+	{
+		std::istringstream lineStream(line);
+		std::string hash, name, target;
+		if (!(lineStream >> hash >> name))
+			continue;
+		lineStream >> target;
+
+		if (!target.empty())
+			symbolicRefs[name] = target;
+		else if (IsObjectId(hash))
+			refs[name] = hash;
+		else
+			return false;
+	}
+
+	return true;
+}
+
+bool RefStore::ReadPackedRefs(const std::string& fileName)
+{
+	std::ifstream file(fileName.c_str());
+	if (!file.is_open())
+		return true;// Not having packed refs is perfectly normal
+
+	std::string line;
+	while (std::getline(file, line))
+	{
+		// Skip header and peeled tag lines ("^<object>")
+		if (line.empty() || line[0] == '#' || line[0] == '^')
+			continue;
+
+		const size_t space(line.find(' '));
+		if (space == std::string::npos)
+			return false;
+
+		const std::string hash(line.substr(0, space));
+		if (!IsObjectId(hash))
+			return false;
+
+		refs[Trim(line.substr(space + 1))] = hash;
+	}
+
+	return true;
+}
+
+bool RefStore::ReadLooseRefs(const std::string& directory,
+	const std::string& prefix)
+{
+	DIR *dp(opendir(directory.c_str()));
+	if (!dp)
+		return false;
+
+	bool success(true);
+	dirent *d;
+	while (success && (d = readdir(dp)) != NULL)
+	{
+		const std::string name(d->d_name);
+		if (name.compare(".") == 0 || name.compare("..") == 0)
+			continue;
+
+		// Leftovers from interrupted ref updates
+		const std::string lockExtension(".lock");
+		if (name.length() > lockExtension.length() &&
+			name.compare(name.length() - lockExtension.length(),
+			lockExtension.length(), lockExtension) == 0)
+			continue;
+
+		bool isDirectory(d->d_type == DT_DIR);
+		if (d->d_type == DT_UNKNOWN)
+		{
+			struct stat info;
+			if (stat((directory + name).c_str(), &info) != 0)
+				continue;
+			isDirectory = S_ISDIR(info.st_mode);
+		}
+
+		if (isDirectory)
+			success = ReadLooseRefs(directory + name + "/", prefix + name + "/");
+		else
+			success = ReadLooseRef(directory + name, prefix + name);
+	}
+
+	closedir(dp);
+	return success;
+}
+
+bool RefStore::ReadLooseRef(const std::string& fileName,
+	const std::string& name)
+{
+	std::string contents;
+	if (!ReadFile(fileName, contents))
+		return false;
+	contents = Trim(contents);
+
+	const std::string symbolicPrefix("ref:");
+	if (contents.compare(0, symbolicPrefix.length(), symbolicPrefix) == 0)
+	{
+		symbolicRefs[name] = Trim(contents.substr(symbolicPrefix.length()));
+		refs.erase(name);
+		return true;
+	}
+
+	if (!IsObjectId(contents))
+		return false;
+
+	refs[name] = contents;
+	symbolicRefs.erase(name);
+	return true;
+}
+
+std::string RefStore::Resolve(const std::string& name) const
+{
+	std::string current(name);
+
+	// Same limit on symbolic ref depth that git uses
+	unsigned int depth;
+	for (depth = 0; depth < 5; depth++)
+	{
+		std::map<std::string, std::string>::const_iterator it(refs.find(current));
+		if (it != refs.end())
+			return it->second;
+
+		it = symbolicRefs.find(current);
+		if (it == symbolicRefs.end())
+			return "";
+		current = it->second;
+	}
+
+	return "";
+}
+
+std::string RefStore::GetSymbolicTarget(const std::string& name) const
+{
+	std::map<std::string, std::string>::const_iterator it(symbolicRefs.find(name));
+	if (it == symbolicRefs.end())
+		return "";
+	return it->second;
+}
+
+std::vector<std::string> RefStore::List(const std::string& prefix) const
+{
+	std::vector<std::string> names;
+	std::map<std::string, std::string>::const_iterator it(refs.lower_bound(prefix));
+	while (it != refs.end() && it->first.compare(0, prefix.length(), prefix) == 0)
+	{
+		names.push_back(it->first);
+		++it;
+	}
+
+	return names;
+}
+
+bool RefStore::ReadFile(const std::string& fileName, std::string& contents)
+{
+	std::ifstream file(fileName.c_str(), std::ios::binary);
+	if (!file.is_open())
+		return false;
+
+	std::ostringstream ss;
+	ss << file.rdbuf();
+	contents = ss.str();
+	return true;
+}
+
+bool RefStore::IsObjectId(const std::string& s)
+{
+	// SHA-1 or SHA-256
+	if (s.length() != 40 && s.length() != 64)
+		return false;
+	return s.find_first_not_of("0123456789abcdef") == std::string::npos;
+}
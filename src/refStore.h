@@ -0,0 +1,57 @@
+// File:  refStore.h
+// Date:  10/18/2026
+// Auth:  agent
+// Desc:  Reads refs directly from HEAD, the loose refs directory tree and
+//        packed-refs without starting git (or from git for-each-ref output
+//        when that isn't possible).
+
+#ifndef REF_STORE_H_
+#define REF_STORE_H_
+
+// Standard C++ headers
+#include <string>
+#include <vector>
+#include <map>
+
+class RefStore
+{
+public:
+	// Accepts the path to the working tree; handles both .git directories
+	// and .git files (submodules and linked worktrees)
+	bool Read(const std::string& path);
+
+	// Loads refs from git for-each-ref output, one ref per line in the form
+	// "<object> <name> <symbolic target>"
+	bool ReadSnapshot(const std::string& forEachRefOutput);
+
+	// Returns the object ID the ref points to, following symbolic refs
+	std::string Resolve(const std::string& name) const;
+
+	// Returns the ref that a symbolic ref points to (empty if not symbolic)
+	std::string GetSymbolicTarget(const std::string& name) const;
+
+	// Returns the full names of all non-symbolic refs beginning with prefix
+	std::vector<std::string> List(const std::string& prefix) const;
+
+	const std::string& GetGitDirectory() const { return gitDirectory; }
+	const std::string& GetCommonDirectory() const { return commonDirectory; }
+
+	static bool FindGitDirectory(const std::string& path,
+		std::string& gitDirectory, std::string& commonDirectory);
+
+private:
+	std::string gitDirectory;
+	std::string commonDirectory;
+
+	std::map<std::string, std::string> refs;// name -> object ID
+	std::map<std::string, std::string> symbolicRefs;// name -> target name
+
+	bool ReadPackedRefs(const std::string& fileName);
+	bool ReadLooseRefs(const std::string& directory, const std::string& prefix);
+	bool ReadLooseRef(const std::string& fileName, const std::string& name);
+
+	static bool ReadFile(const std::string& fileName, std::string& contents);
+	static bool IsObjectId(const std::string& s);
+};
+
+#endif// REF_STORE_H_
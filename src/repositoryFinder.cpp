@@ -0,0 +1,286 @@
+// File:  repositoryFinder.cpp
+// Date:  10/18/2026
+// Auth:  agent
+// Desc:  Parallel directory walk for finding repositories.
+
+// Standard C/C++ headers
+#include <algorithm>
+#include <thread>
+#include <cstring>
+
+#ifdef _WIN32
+// Windows headers
+#include "windirent.h"// Local, but 3rd party
+#else
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#endif
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#endif
+
+// Local headers
+#include "repositoryFinder.h"
+#include "performanceStats.h"
+
+const unsigned int RepositoryFinder::maxOpenHandles(256);
+
+RepositoryFinder::RepositoryFinder(const unsigned int& threadCount,
+	const unsigned int& maxDepth, FoundFunction found)
+	: threadCount(std::max(threadCount, 1U)), maxDepth(maxDepth), found(found),
+	openHandles(0)
+{
+	activeCount = 0;
+}
+
+RepositoryFinder::DirectoryHandle::DirectoryHandle(const int& fd,
+	std::atomic<unsigned int>& openCount) : fd(fd), openCount(openCount)
+{
+	openCount++;
+}
+
+RepositoryFinder::DirectoryHandle::~DirectoryHandle()
+{
+#ifndef _WIN32
+	close(fd);
+#endif
+	openCount--;
+}
+
+void RepositoryFinder::Search(const std::string& path)
+{
+	root.reset(new Node(path, std::string(), 0));
+	cursor.assign(1, root.get());
+	pending.assign(1, root.get());
+	activeCount = 0;
+
+	std::vector<std::thread> workers;
+	unsigned int i;
+	for (i = 0; i < threadCount; i++)
+		workers.push_back(std::thread(&RepositoryFinder::WorkerThread, this));
+
+	for (i = 0; i < workers.size(); i++)
+		workers[i].join();
+
+	root.reset();
+}
+
+void RepositoryFinder::WorkerThread()
+{
+	std::unique_lock<std::mutex> lock(mutex);
+	while (true)
+	{
+		// Only finished once nobody is listing a directory that could add more work
+		condition.wait(lock, [this]()
+		{
+			return !pending.empty() || activeCount == 0;
+		});
+
+		if (pending.empty())
+			break;
+
+		Node* node(pending.front());
+		pending.pop_front();
+		activeCount++;
+
+		lock.unlock();
+		{
+			// Only the listing is timed, not waiting for work or for the
+			// scanner to accept what was found
+			PerformanceStats::PhaseTimer timer(PerformanceStats::PhaseDiscovery);
+			List(*node);
+		}
+		lock.lock();
+
+		node->listed = true;
+		unsigned int i;
+		for (i = 0; i < node->children.size(); i++)
+		{
+			if (!node->children[i]->listed)
+				pending.push_back(node->children[i].get());
+		}
+
+		AdvanceCursor();
+		activeCount--;
+		condition.notify_all();
+	}
+}
+
+// Fills in the node's children - the node is not shared with other threads
+// until it is marked as listed
+void RepositoryFinder::List(Node& node)
+{
+	// Directories at the depth limit are reported without being read
+	const bool atLimit(maxDepth > 0 && node.depth + 1 >= maxDepth);
+
+	// The search path itself is read in full even if it's a repository
+	std::vector<std::string> subdirectories;
+	bool stop(false);
+	std::shared_ptr<DirectoryHandle> handle;
+	if (!ReadDirectory(node, subdirectories, stop, node.depth > 0, !atLimit, handle))
+	{
+		// Let the scanner report on directories we can't read
+		node.report = node.depth > 0;
+		return;
+	}
+
+	// Anything inside the search path itself is still checked
+	if (stop && node.depth > 0)
+	{
+		node.report = true;
+		return;
+	}
+
+	std::sort(subdirectories.begin(), subdirectories.end());
+
+	unsigned int i;
+	for (i = 0; i < subdirectories.size(); i++)
+	{
+		node.children.push_back(std::unique_ptr<Node>(new Node(
+			node.path + subdirectories[i] + "/", subdirectories[i], node.depth + 1)));
+		node.children.back()->parent = handle;
+		if (atLimit)
+		{
+			node.children.back()->listed = true;
+			node.children.back()->report = true;
+		}
+	}
+}
+
+// Must be called with the mutex locked
+void RepositoryFinder::AdvanceCursor()
+{
+	while (!cursor.empty())
+	{
+		Node* node(cursor.back());
+		if (!node->listed)
+			return;
+
+		if (node->report)
+		{
+			found(node->path);
+			node->report = false;
+		}
+
+		if (node->nextChild < node->children.size())
+		{
+			cursor.push_back(node->children[node->nextChild++].get());
+			continue;
+		}
+
+		// Free each directory once everything below it has been reported
+		cursor.pop_back();
+		if (!cursor.empty())
+			cursor.back()->children[cursor.back()->nextChild - 1].reset();
+	}
+}
+
+bool RepositoryFinder::IsStopName(const char* name)
+{
+	return strcmp(name, ".git") == 0 || strcmp(name, ".ignore") == 0;
+}
+
+bool RepositoryFinder::ReadDirectory(Node& node,
+	std::vector<std::string>& subdirectories, bool& stop, const bool& stopEarly,
+	const bool& keepOpen, std::shared_ptr<DirectoryHandle>& handle)
+{
+	stop = false;
+
+#ifdef __linux__
+	// Opening relative to the parent avoids looking up the whole path again
+	// (and following a symlink that replaced the directory since it was read)
+	int fd;
+	if (node.parent)
+		fd = openat(node.parent->fd, node.name.c_str(),
+			O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+	else if (node.depth > 0)
+		fd = open(node.path.c_str(), O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+	else
+		fd = open(node.path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+	node.parent.reset();
+	if (fd < 0)
+		return false;
+
+	// Same layout as the kernel's linux_dirent64
+	struct DirectoryEntry
+	{
+		uint64_t inode;
+		int64_t offset;
+		unsigned short length;
+		unsigned char type;
+		char name[1];
+	};
+
+	// Large reads keep the number of system calls down in big directories
+	std::vector<char> buffer(64 * 1024);
+	long bytesRead;
+	while ((bytesRead = syscall(SYS_getdents64, fd, buffer.data(), buffer.size())) > 0)
+	{
+		long position(0);
+		while (position < bytesRead)
+		{
+			const DirectoryEntry* entry(reinterpret_cast<const DirectoryEntry*>(
+				buffer.data() + position));
+			position += entry->length;
+
+			if (IsStopName(entry->name))
+			{
+				stop = true;
+				if (stopEarly)
+				{
+					close(fd);
+					return true;
+				}
+				continue;
+			}
+
+			if (strcmp(entry->name, ".") == 0 || strcmp(entry->name, "..") == 0)
+				continue;
+
+			bool isDirectory(entry->type == DT_DIR);
+			if (entry->type == DT_UNKNOWN)
+			{
+				struct stat info;
+				isDirectory = fstatat(fd, entry->name, &info, AT_SYMLINK_NOFOLLOW) == 0 &&
+					S_ISDIR(info.st_mode);
+			}
+
+			if (isDirectory)
+				subdirectories.push_back(entry->name);
+		}
+	}
+
+	if (bytesRead == 0 && keepOpen && !subdirectories.empty() &&
+		openHandles < maxOpenHandles)
+		handle = std::make_shared<DirectoryHandle>(fd, openHandles);
+	else
+		close(fd);
+	return bytesRead == 0;
+#else
+	DIR *dp(opendir(node.path.c_str()));
+	if (!dp)
+		return false;
+
+	dirent *d;
+	while ((d = readdir(dp)) != NULL)
+	{
+		if (IsStopName(d->d_name))
+		{
+			stop = true;
+			if (stopEarly)
+				break;
+			continue;
+		}
+
+		if (d->d_type == DT_DIR && strcmp(d->d_name, ".") != 0 &&
+			strcmp(d->d_name, "..") != 0)
+			subdirectories.push_back(d->d_name);
+	}
+
+	closedir(dp);
+	return true;
+#endif
+}
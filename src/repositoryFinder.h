@@ -0,0 +1,102 @@
+// File:  repositoryFinder.h
+// Date:  10/18/2026
+// Auth:  agent
+// Desc:  Walks a directory tree in parallel looking for repositories.  Found
+//        directories are passed on as soon as every directory that sorts
+//        before them has been visited.
+
+#ifndef REPOSITORY_FINDER_H_
+#define REPOSITORY_FINDER_H_
+
+// Standard C++ headers
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+
+class RepositoryFinder
+{
+public:
+	typedef std::function<void(const std::string& path)> FoundFunction;
+
+	// A maximum depth of zero means unlimited.  Depth one only looks at the
+	// immediate subdirectories of the search path.
+	RepositoryFinder(const unsigned int& threadCount,
+		const unsigned int& maxDepth, FoundFunction found);
+
+	// Calls found (in sorted order, one at a time) with each subdirectory that
+	// contains a repository or an ignore file, or that is at the maximum
+	// depth.  Repositories and ignored directories are not searched further.
+	// Blocks until the search is complete.
+	void Search(const std::string& path);
+
+private:
+	const unsigned int threadCount;
+	const unsigned int maxDepth;
+	const FoundFunction found;
+
+	// An open directory, kept while any of its children are still waiting to
+	// be listed so that they can be opened relative to it
+	class DirectoryHandle
+	{
+	public:
+		DirectoryHandle(const int& fd, std::atomic<unsigned int>& openCount);
+		~DirectoryHandle();
+
+		const int fd;
+
+	private:
+		std::atomic<unsigned int>& openCount;
+
+		DirectoryHandle(const DirectoryHandle&);
+		DirectoryHandle& operator=(const DirectoryHandle&);
+	};
+
+	// Beyond this, directories are opened by their full path instead
+	static const unsigned int maxOpenHandles;
+	std::atomic<unsigned int> openHandles;
+
+	struct Node
+	{
+		Node(const std::string& path, const std::string& name,
+			const unsigned int& depth) : path(path), name(name), depth(depth),
+			listed(false), report(false), nextChild(0) {}
+
+		const std::string path;// Includes trailing slash
+		const std::string name;
+		const unsigned int depth;
+		std::shared_ptr<DirectoryHandle> parent;
+
+		bool listed;
+		bool report;
+		std::vector<std::unique_ptr<Node> > children;
+		unsigned int nextChild;
+	};
+
+	std::mutex mutex;
+	std::condition_variable condition;
+	std::deque<Node*> pending;
+	unsigned int activeCount;
+
+	// Directories are reported in depth-first order by following a cursor
+	// down the tree; the cursor waits at any directory not yet listed
+	std::unique_ptr<Node> root;
+	std::vector<Node*> cursor;
+
+	void WorkerThread();
+	void List(Node& node);
+	void AdvanceCursor();
+
+	// The rest of the directory is still read after a stop name when
+	// stopEarly is false; the handle is only set if keepOpen is true
+	bool ReadDirectory(Node& node, std::vector<std::string>& subdirectories,
+		bool& stop, const bool& stopEarly, const bool& keepOpen,
+		std::shared_ptr<DirectoryHandle>& handle);
+	static bool IsStopName(const char* name);
+};
+
+#endif// REPOSITORY_FINDER_H_
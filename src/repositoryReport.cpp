@@ -0,0 +1,222 @@
+// File:  repositoryReport.cpp
+// Date:  10/18/2026
+// Auth:  agent
+// Desc:  Results of checking one repository.
+
+// Standard C++ headers
+#include <sstream>
+#include <iomanip>
+
+// Local headers
+#include "repositoryReport.h"
+#include "stringUtilities.h"
+
+std::string RepositoryReport::FormatText(bool& separate, bool& needsSpaceAfter) const
+{
+	std::ostringstream out;
+	separate = false;
+	needsSpaceAfter = false;
+
+	if (statusTimedOut)
+	{
+		out << name << "\n";
+		out << "  -> Timed out checking status\n\n";
+		separate = true;
+	}
+	else if (IsDirty())
+	{
+		out << name << "\n";
+		if (uncommittedCount > 0)
+			out << "  -> Uncommitted changes" << FormatCount(uncommittedCount) << "\n";
+		if (unstagedCount > 0)
+			out << "  -> Unstaged changes" << FormatCount(unstagedCount) << "\n";
+		if (untrackedCount > 0)
+			out << "  -> Untracked files" << FormatCount(untrackedCount) << "\n";
+
+		out << "\n";
+		separate = true;
+	}
+	else if (remoteCount == 0)
+	{
+		out << "No remotes for " << name << "\n";
+		needsSpaceAfter = true;
+	}
+	else if (fetchState == FetchFailed || fetchState == FetchTimedOut)
+	{
+		out << name << "\n";
+		unsigned int i;
+		for (i = 0; i < fetchErrors.size(); i++)
+		{
+			if (fetchErrors[i].timedOut)
+				out << "  Timed out fetching from " << fetchErrors[i].remote << "\n";
+			else
+				out << "  Failed to fetch from " << fetchErrors[i].remote << "\n";
+		}
+		out << "\n";
+		separate = true;
+	}
+	else
+	{
+		bool printedName(false);
+		unsigned int i;
+		for (i = 0; i < branches.size(); i++)
+		{
+			const BranchReport& branch(branches[i]);
+			if (branch.status.code == GitInterface::StatusUpToDate)
+				continue;
+
+			if (!printedName)
+			{
+				out << name;
+				printedName = true;
+			}
+
+			out << "\n ==> " << branch.remote << ":" << branch.branch;
+			if (branch.status.ahead > 0 || branch.status.behind > 0)
+				out << " (" << branch.status.ahead << " ahead / "
+					<< branch.status.behind << " behind)";
+
+			if (branch.action == BranchReport::ActionPushed)
+				out << " is now up-to-date";
+			else if (branch.action == BranchReport::ActionPushFailed)
+			{
+				if (!branch.error.empty())
+					out << " " << branch.error << ";";
+				out << " push failed";
+			}
+			else if (branch.status.code == GitInterface::StatusRemoteAhead)
+			{
+				// if (ff possible)
+				// merge
+				// else
+				// See:  http://stackoverflow.com/questions/15316601/in-what-cases-could-git-pull-be-harmful
+				out << " is behind remote and requires user action";
+			}
+			else if (branch.status.code == GitInterface::StatusDiverged)
+				out << " has diverged from remote and requires user action";
+			else if (branch.status.code == GitInterface::StatusLocalMissingBranch)
+				out << " branch does not exist locally";
+			else if (branch.status.code == GitInterface::StatusTimedOut)
+				out << " timed out comparing with remote";
+			else if (branch.status.code == GitInterface::StatusError)
+				out << " failed to compare with remote";
+		}
+
+		if (printedName)
+		{
+			out << "\n\n";
+			separate = true;
+		}
+	}
+
+	return out.str();
+}
+
+std::string RepositoryReport::FormatJson() const
+{
+	std::ostringstream out;
+	out << "{\"type\":\"repository\",\"name\":\"" << EscapeJson(name)
+		<< "\",\"path\":\"" << EscapeJson(path)
+		<< "\",\"submodule\":" << (isSubModule ? "true" : "false");
+	if (statusTimedOut)
+		out << ",\"statusTimedOut\":true";
+	out << ",\"uncommitted\":" << uncommittedCount
+		<< ",\"unstaged\":" << unstagedCount
+		<< ",\"untracked\":" << untrackedCount
+		<< ",\"exactCounts\":" << (exactCounts ? "true" : "false")
+		<< ",\"remotes\":" << remoteCount
+		<< ",\"fetch\":\"" << GetFetchStateName(fetchState) << "\"";
+	unsigned int i;
+	if (!fetchErrors.empty())
+	{
+		out << ",\"fetchErrors\":[";
+		for (i = 0; i < fetchErrors.size(); i++)
+		{
+			if (i > 0)
+				out << ",";
+			out << "{\"remote\":\"" << EscapeJson(fetchErrors[i].remote)
+				<< "\",\"message\":\"" << EscapeJson(fetchErrors[i].message) << "\"}";
+		}
+		out << "]";
+	}
+
+	out << ",\"branches\":[";
+	for (i = 0; i < branches.size(); i++)
+	{
+		const BranchReport& branch(branches[i]);
+		if (i > 0)
+			out << ",";
+		out << "{\"remote\":\"" << EscapeJson(branch.remote)
+			<< "\",\"branch\":\"" << EscapeJson(branch.branch)
+			<< "\",\"status\":\"" << GetStatusName(branch.status.code)
+			<< "\",\"ahead\":" << branch.status.ahead
+			<< ",\"behind\":" << branch.status.behind;
+		if (branch.action == BranchReport::ActionPushed)
+			out << ",\"action\":\"pushed\"";
+		else if (branch.action == BranchReport::ActionPushFailed)
+		{
+			out << ",\"action\":\"push-failed\"";
+			if (!branch.error.empty())
+				out << ",\"error\":\"" << EscapeJson(branch.error) << "\"";
+		}
+		out << "}";
+	}
+
+	out << "],\"timings\":{" << std::fixed << std::setprecision(6)
+		<< "\"status\":" << statusTime
+		<< ",\"fetch\":" << fetchTime
+		<< ",\"compare\":" << compareTime
+		<< ",\"push\":" << pushTime << "}}\n";
+
+	return out.str();
+}
+
+std::string RepositoryReport::FormatCount(const unsigned int& count) const
+{
+	if (!exactCounts)
+		return std::string();
+
+	std::ostringstream ss;
+	ss << " (" << count << ")";
+	return ss.str();
+}
+
+const char* RepositoryReport::GetStatusName(const GitInterface::StatusCode& code)
+{
+	switch (code)
+	{
+	case GitInterface::StatusUpToDate:
+		return "up-to-date";
+	case GitInterface::StatusLocalAhead:
+		return "local-ahead";
+	case GitInterface::StatusRemoteAhead:
+		return "remote-ahead";
+	case GitInterface::StatusDiverged:
+		return "diverged";
+	case GitInterface::StatusRemoteMissingBranch:
+		return "remote-missing-branch";
+	case GitInterface::StatusLocalMissingBranch:
+		return "local-missing-branch";
+	case GitInterface::StatusTimedOut:
+		return "timeout";
+	case GitInterface::StatusError:
+		return "error";
+	default:
+		return "unknown";
+	}
+}
+
+const char* RepositoryReport::GetFetchStateName(const FetchState& state)
+{
+	switch (state)
+	{
+	case FetchSucceeded:
+		return "ok";
+	case FetchFailed:
+		return "failed";
+	case FetchTimedOut:
+		return "timeout";
+	default:
+		return "skipped";
+	}
+}
@@ -0,0 +1,85 @@
+// File:  repositoryReport.h
+// Date:  10/18/2026
+// Auth:  agent
+// Desc:  Results of checking one repository, and the text and JSON forms in
+//        which they are written.
+
+#ifndef REPOSITORY_REPORT_H_
+#define REPOSITORY_REPORT_H_
+
+// Standard C++ headers
+#include <string>
+#include <vector>
+
+// Local headers
+#include "gitInterface.h"
+
+struct RepositoryReport
+{
+	RepositoryReport() : isSubModule(false), statusTimedOut(false), uncommittedCount(0), unstagedCount(0),
+		untrackedCount(0), exactCounts(true), remoteCount(0), fetchState(FetchSkipped), statusTime(0.0),
+		fetchTime(0.0), compareTime(0.0), pushTime(0.0) {}
+
+	struct BranchReport
+	{
+		BranchReport() : action(ActionNone) {}
+
+		enum Action
+		{
+			ActionNone,
+			ActionPushed,
+			ActionPushFailed
+		};
+
+		std::string remote;
+		std::string branch;
+		GitInterface::RepositoryStatus status;
+		Action action;
+		std::string error;
+	};
+
+	enum FetchState
+	{
+		FetchSkipped,// Dirty, no remotes, or re-checking in watch mode
+		FetchSucceeded,
+		FetchFailed,
+		FetchTimedOut
+	};
+
+	std::string name;
+	std::string path;
+	bool isSubModule;
+	bool statusTimedOut;
+
+	unsigned int uncommittedCount;
+	unsigned int unstagedCount;
+	unsigned int untrackedCount;
+	bool exactCounts;// False if the status check stopped at the first changes
+	bool IsDirty() const { return uncommittedCount + unstagedCount + untrackedCount > 0; }
+
+	unsigned int remoteCount;
+	FetchState fetchState;
+	std::vector<GitInterface::FetchError> fetchErrors;
+
+	std::vector<BranchReport> branches;
+
+	// [sec]
+	double statusTime;// Includes submodules
+	double fetchTime;
+	double compareTime;
+	double pushTime;
+
+	// The text form includes blank lines appropriate for the report's kind,
+	// and indicates how it should be separated from the reports around it
+	std::string FormatText(bool& separate, bool& needsSpaceAfter) const;
+
+	// One line, including the trailing newline
+	std::string FormatJson() const;
+
+private:
+	std::string FormatCount(const unsigned int& count) const;
+	static const char* GetStatusName(const GitInterface::StatusCode& code);
+	static const char* GetFetchStateName(const FetchState& state);
+};
+
+#endif// REPOSITORY_REPORT_H_
@@ -0,0 +1,280 @@
+// File:  repositoryWatcher.cpp
+// Date:  10/18/2026
+// Auth:  agent
+// Desc:  Waits for repository changes using inotify.
+
+// Standard C/C++ headers
+#include <cstring>
+#include <chrono>
+
+#ifdef __linux__
+#include <dirent.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+#endif
+
+// Local headers
+#include "repositoryWatcher.h"
+#include "refStore.h"
+#include "statusCache.h"
+
+#ifdef __linux__
+
+static const uint32_t workTreeMask(IN_CREATE | IN_DELETE | IN_MOVED_FROM |
+	IN_MOVED_TO | IN_CLOSE_WRITE | IN_ATTRIB | IN_ONLYDIR);
+static const uint32_t metadataMask(IN_CREATE | IN_DELETE | IN_MOVED_FROM |
+	IN_MOVED_TO | IN_CLOSE_WRITE | IN_ONLYDIR);
+
+// Longest we wait for events to stop, in debounce periods
+static const unsigned int maxDebouncePeriods(10);
+
+RepositoryWatcher::RepositoryWatcher()
+{
+	fd = -1;
+}
+
+RepositoryWatcher::~RepositoryWatcher()
+{
+	if (fd >= 0)
+		close(fd);
+}
+
+bool RepositoryWatcher::IsSupported()
+{
+	return true;
+}
+
+bool RepositoryWatcher::Initialize()
+{
+	fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	return fd >= 0;
+}
+
+bool RepositoryWatcher::Add(const std::string& path)
+{
+	Repository repository;
+	repository.path = path;
+	if (!RefStore::FindGitDirectory(path, repository.gitDirectory,
+		repository.commonDirectory))
+		return false;
+	repository.checkedFingerprint = StatusCache::ComputeFingerprint(path);
+
+	const unsigned int index(repositories.size());
+	repositories.push_back(repository);
+
+	// Only the top level of the working tree is watched - a recursive watch on
+	// every working tree would quickly exhaust the kernel's watch limit
+	bool ok(AddWatch(index, path, true) &&
+		AddWatch(index, repository.gitDirectory, false));
+	if (repository.commonDirectory.compare(repository.gitDirectory) != 0)
+		ok = AddWatch(index, repository.commonDirectory, false) && ok;
+	AddRefsWatches(index, repository.commonDirectory + "refs/");
+
+	return ok;
+}
+
+bool RepositoryWatcher::AddWatch(const unsigned int& repository,
+	const std::string& path, const bool& isWorkTree)
+{
+	const int wd(inotify_add_watch(fd, path.c_str(),
+		isWorkTree ? workTreeMask : metadataMask));
+	if (wd < 0)
+		return false;
+
+	// Linked worktrees share a common directory, so one watch can belong to
+	// several repositories
+	std::vector<Watch>& list(watches[wd]);
+	unsigned int i;
+	for (i = 0; i < list.size(); i++)
+	{
+		if (list[i].repository == repository)
+			return true;
+	}
+
+	Watch watch;
+	watch.repository = repository;
+	watch.isWorkTree = isWorkTree;
+	watch.path = path;
+	list.push_back(watch);
+	return true;
+}
+
+void RepositoryWatcher::AddRefsWatches(const unsigned int& repository,
+	const std::string& path)
+{
+	if (!AddWatch(repository, path, false))
+		return;
+
+	DIR *dp(opendir(path.c_str()));
+	if (!dp)
+		return;
+
+	dirent *d;
+	while ((d = readdir(dp)) != NULL)
+	{
+		if (d->d_type == DT_DIR && strcmp(d->d_name, ".") != 0 &&
+			strcmp(d->d_name, "..") != 0)
+			AddRefsWatches(repository, path + d->d_name + "/");
+	}
+	closedir(dp);
+}
+
+void RepositoryWatcher::MarkChecked(const std::string& path)
+{
+	unsigned int i;
+	for (i = 0; i < repositories.size(); i++)
+	{
+		if (repositories[i].path.compare(path) == 0)
+			repositories[i].checkedFingerprint = StatusCache::ComputeFingerprint(path);
+	}
+}
+
+std::vector<std::string> RepositoryWatcher::WaitForChanges(
+	const unsigned int& debounceMilliseconds)
+{
+	std::set<unsigned int> changed;
+	while (changed.empty())
+	{
+		std::set<unsigned int> workTreeChanges, metadataChanges;
+		while (!ReadEvents(-1, workTreeChanges, metadataChanges))
+		{
+		}
+
+		// Something that keeps writing (e.g. a build in one working tree)
+		// must not hold back the others indefinitely
+		const std::chrono::steady_clock::time_point giveUp(std::chrono::steady_clock::now() +
+			std::chrono::milliseconds(debounceMilliseconds * maxDebouncePeriods));
+		while (std::chrono::steady_clock::now() < giveUp &&
+			ReadEvents(debounceMilliseconds, workTreeChanges, metadataChanges))
+		{
+		}
+
+		// Working tree changes are never caused by us, but .git is written by
+		// the commands we run, so only count it if the result differs
+		changed = workTreeChanges;
+		std::set<unsigned int>::const_iterator it;
+		for (it = metadataChanges.begin(); it != metadataChanges.end(); ++it)
+		{
+			if (StatusCache::ComputeFingerprint(repositories[*it].path) !=
+				repositories[*it].checkedFingerprint)
+				changed.insert(*it);
+		}
+	}
+
+	std::vector<std::string> paths;
+	std::set<unsigned int>::const_iterator it;
+	for (it = changed.begin(); it != changed.end(); ++it)
+		paths.push_back(repositories[*it].path);
+
+	return paths;
+}
+
+bool RepositoryWatcher::ReadEvents(const int& timeoutMilliseconds,
+	std::set<unsigned int>& workTreeChanges, std::set<unsigned int>& metadataChanges)
+{
+	struct pollfd pfd;
+	pfd.fd = fd;
+	pfd.events = POLLIN;
+	if (poll(&pfd, 1, timeoutMilliseconds) <= 0)
+		return false;
+
+	alignas(struct inotify_event) char buffer[64 * 1024];
+	const ssize_t bytesRead(read(fd, buffer, sizeof(buffer)));
+	if (bytesRead <= 0)
+		return true;
+
+	const std::string lockSuffix(".lock");
+	ssize_t position(0);
+	while (position < bytesRead)
+	{
+		const struct inotify_event* event(
+			reinterpret_cast<const struct inotify_event*>(buffer + position));
+		position += sizeof(struct inotify_event) + event->len;
+
+		// Events were lost, so anything could have changed
+		if (event->mask & IN_Q_OVERFLOW)
+		{
+			unsigned int i;
+			for (i = 0; i < repositories.size(); i++)
+				workTreeChanges.insert(i);
+			continue;
+		}
+
+		std::map<int, std::vector<Watch> >::iterator it(watches.find(event->wd));
+		if (it == watches.end())
+			continue;
+
+		if (event->mask & IN_IGNORED)
+		{
+			watches.erase(it);
+			continue;
+		}
+
+		const std::string name(event->len > 0 ? event->name : "");
+		const std::vector<Watch> list(it->second);
+		unsigned int i;
+		for (i = 0; i < list.size(); i++)
+		{
+			const Repository& repository(repositories[list[i].repository]);
+			if (list[i].isWorkTree)
+			{
+				if (name.compare(".git") != 0)
+					workTreeChanges.insert(list[i].repository);
+				continue;
+			}
+
+			// Lock files come and go even when nothing is written
+			if (name.length() > lockSuffix.length() &&
+				name.compare(name.length() - lockSuffix.length(),
+				lockSuffix.length(), lockSuffix) == 0)
+				continue;
+
+			const std::string refsDirectory(repository.commonDirectory + "refs/");
+			if ((event->mask & IN_CREATE) && (event->mask & IN_ISDIR) &&
+				list[i].path.compare(0, refsDirectory.length(), refsDirectory) == 0)
+				AddRefsWatches(list[i].repository, list[i].path + name + "/");
+
+			metadataChanges.insert(list[i].repository);
+		}
+	}
+
+	return true;
+}
+
+#else
+
+RepositoryWatcher::RepositoryWatcher()
+{
+	fd = -1;
+}
+
+RepositoryWatcher::~RepositoryWatcher()
+{
+}
+
+bool RepositoryWatcher::IsSupported()
+{
+	return false;
+}
+
+bool RepositoryWatcher::Initialize()
+{
+	return false;
+}
+
+bool RepositoryWatcher::Add(const std::string&)
+{
+	return false;
+}
+
+void RepositoryWatcher::MarkChecked(const std::string&)
+{
+}
+
+std::vector<std::string> RepositoryWatcher::WaitForChanges(const unsigned int&)
+{
+	return std::vector<std::string>();
+}
+
+#endif
@@ -0,0 +1,72 @@
+// File:  repositoryWatcher.h
+// Date:  10/18/2026
+// Auth:  agent
+// Desc:  Waits for changes to repository metadata and working trees using
+//        inotify (Linux only).
+
+#ifndef REPOSITORY_WATCHER_H_
+#define REPOSITORY_WATCHER_H_
+
+// Standard C++ headers
+#include <string>
+#include <vector>
+#include <map>
+#include <set>
+#include <cstdint>
+
+class RepositoryWatcher
+{
+public:
+	RepositoryWatcher();
+	~RepositoryWatcher();
+
+	static bool IsSupported();
+	bool Initialize();
+
+	// Watches the top level of the working tree, the git directory and the
+	// refs directories
+	bool Add(const std::string& path);
+
+	// Records the state of .git after the repository was checked, so changes
+	// we caused ourselves (e.g. git status refreshing the index) are ignored
+	void MarkChecked(const std::string& path);
+
+	// Blocks until at least one repository changes and no further events have
+	// arrived for the debounce period (or events have kept arriving for ten
+	// periods), then returns the changed repositories
+	std::vector<std::string> WaitForChanges(const unsigned int& debounceMilliseconds);
+
+private:
+	int fd;
+
+	struct Repository
+	{
+		std::string path;
+		std::string gitDirectory;
+		std::string commonDirectory;
+		uint64_t checkedFingerprint;
+	};
+
+	struct Watch
+	{
+		unsigned int repository;
+		bool isWorkTree;
+		std::string path;
+	};
+
+	std::vector<Repository> repositories;
+	std::map<int, std::vector<Watch> > watches;
+
+	bool AddWatch(const unsigned int& repository, const std::string& path,
+		const bool& isWorkTree);
+	void AddRefsWatches(const unsigned int& repository, const std::string& path);
+
+	// Returns false on timeout
+	bool ReadEvents(const int& timeoutMilliseconds, std::set<unsigned int>& workTreeChanges,
+		std::set<unsigned int>& metadataChanges);
+
+	RepositoryWatcher(const RepositoryWatcher&);
+	RepositoryWatcher& operator=(const RepositoryWatcher&);
+};
+
+#endif// REPOSITORY_WATCHER_H_
@@ -0,0 +1,121 @@
+// File:  scanEngine.cpp
+// Date:  10/18/2026
+// Auth:  agent
+// Desc:  Worker pool for checking repositories concurrently.
+
+// Standard C++ headers
+#include <cassert>
+#include <algorithm>
+
+// Local headers
+#include "scanEngine.h"
+
+ScanEngine::ScanEngine(const unsigned int& jobCount, ProcessFunction process,
+	EmitFunction emit, FlushFunction flush) : process(process), emit(emit),
+	flush(flush), windowSize(std::max(jobCount, 1U) * 32)
+{
+	nextIndex = 0;
+	nextToEmit = 0;
+	inputClosed = false;
+
+	unsigned int i;
+	for (i = 0; i < std::max(jobCount, 1U); i++)
+		workers.push_back(std::thread(&ScanEngine::WorkerThread, this));
+}
+
+ScanEngine::~ScanEngine()
+{
+	Finish();
+}
+
+void ScanEngine::Enqueue(const std::string& path)
+{
+	// The index is reserved before waiting, so callers on other threads can't
+	// take it; a caller with a lower index never waits longer than this one
+	unsigned int index;
+	{
+		std::lock_guard<std::mutex> lock(queueMutex);
+		assert(!inputClosed);
+		index = nextIndex++;
+	}
+
+	{
+		std::unique_lock<std::mutex> lock(outputMutex);
+		while (index - nextToEmit >= windowSize)
+			windowCondition.wait(lock);
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(queueMutex);
+		pending.push_back(std::make_pair(index, path));
+	}
+	queueCondition.notify_one();
+}
+
+void ScanEngine::Finish()
+{
+	{
+		std::lock_guard<std::mutex> lock(queueMutex);
+		inputClosed = true;
+	}
+	queueCondition.notify_all();
+
+	unsigned int i;
+	for (i = 0; i < workers.size(); i++)
+	{
+		if (workers[i].joinable())
+			workers[i].join();
+	}
+
+	assert(completed.empty());
+}
+
+void ScanEngine::WorkerThread()
+{
+	std::pair<unsigned int, std::string> item;
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(queueMutex);
+			while (pending.empty() && !inputClosed)
+				queueCondition.wait(lock);
+
+			if (pending.empty())
+				return;
+
+			item = pending.front();
+			pending.pop_front();
+		}
+
+		Result result;
+		result.path = item.second;
+		process(item.second, result);
+		Complete(item.first, result);
+	}
+}
+
+void ScanEngine::Complete(const unsigned int& index, Result& result)
+{
+	std::lock_guard<std::mutex> lock(outputMutex);
+	if (index != nextToEmit)
+	{
+		completed[index] = std::move(result);
+		return;
+	}
+
+	emit(result);
+	nextToEmit++;
+
+	std::map<unsigned int, Result>::iterator it(completed.begin());
+	while (it != completed.end() && it->first == nextToEmit)
+	{
+		emit(it->second);
+		nextToEmit++;
+		it = completed.erase(it);
+	}
+
+	if (flush)
+		flush();
+
+	windowCondition.notify_all();
+}
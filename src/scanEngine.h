@@ -0,0 +1,86 @@
+// File:  scanEngine.h
+// Date:  10/18/2026
+// Auth:  agent
+// Desc:  Worker pool for checking repositories concurrently.  Results are
+//        emitted in the order in which directories were enqueued, and only
+//        a fixed number of directories may be outstanding at once, so a
+//        slow repository can't cause every later result to pile up in memory.
+
+#ifndef SCAN_ENGINE_H_
+#define SCAN_ENGINE_H_
+
+// Standard C++ headers
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+class ScanEngine
+{
+public:
+	struct Result
+	{
+		Result() : type(TypeRepository), separate(false), needsSpaceAfter(false) {}
+
+		enum Type
+		{
+			TypeRepository,
+			TypeNotRepository,
+			TypeIgnored
+		};
+
+		std::string path;
+		Type type;
+		std::string output;
+
+		// Controls blank lines between consecutive output blocks
+		bool separate;
+		bool needsSpaceAfter;
+	};
+
+	typedef std::function<void(const std::string& path, Result& result)> ProcessFunction;
+	typedef std::function<void(const Result& result)> EmitFunction;
+	typedef std::function<void()> FlushFunction;
+
+	// The flush function (optional) is called after each group of results
+	// that become ready together has been emitted
+	ScanEngine(const unsigned int& jobCount, ProcessFunction process,
+		EmitFunction emit, FlushFunction flush = FlushFunction());
+	~ScanEngine();
+
+	// Blocks while the window of outstanding directories is full; may be called
+	// from any thread
+	void Enqueue(const std::string& path);
+
+	// Blocks until every enqueued directory has been processed and emitted
+	void Finish();
+
+private:
+	const ProcessFunction process;
+	const EmitFunction emit;
+	const FlushFunction flush;
+
+	std::vector<std::thread> workers;
+
+	std::mutex queueMutex;
+	std::condition_variable queueCondition;
+	std::deque<std::pair<unsigned int, std::string> > pending;
+	unsigned int nextIndex;
+	bool inputClosed;
+
+	// Reorder buffer - results wait here until all earlier results are emitted
+	std::mutex outputMutex;
+	std::map<unsigned int, Result> completed;
+	unsigned int nextToEmit;
+	const unsigned int windowSize;
+	std::condition_variable windowCondition;
+
+	void WorkerThread();
+	void Complete(const unsigned int& index, Result& result);
+};
+
+#endif// SCAN_ENGINE_H_
@@ -0,0 +1,143 @@
+// File:  sha1.cpp
+// Date:  10/18/2026
+// Auth:  agent
+// Desc:  SHA-1 digest, for computing git object IDs.
+
+// Standard C/C++ headers
+#include <cstring>
+#include <sstream>
+#include <algorithm>
+
+// Local headers
+#include "sha1.h"
+
+Sha1::Sha1()
+{
+	state[0] = 0x67452301;
+	state[1] = 0xEFCDAB89;
+	state[2] = 0x98BADCFE;
+	state[3] = 0x10325476;
+	state[4] = 0xC3D2E1F0;
+	length = 0;
+	blockUsed = 0;
+}
+
+static uint32_t RotateLeft(const uint32_t& value, const unsigned int& bits)
+{
+	return (value << bits) | (value >> (32 - bits));
+}
+
+void Sha1::Update(const void* data, const size_t& dataLength)
+{
+	const unsigned char* p(static_cast<const unsigned char*>(data));
+	size_t remaining(dataLength);
+	length += dataLength;
+
+	if (blockUsed > 0)
+	{
+		const size_t count(std::min(remaining, sizeof(block) - blockUsed));
+		memcpy(block + blockUsed, p, count);
+		blockUsed += count;
+		p += count;
+		remaining -= count;
+		if (blockUsed < sizeof(block))
+			return;
+
+		ProcessBlock(block);
+		blockUsed = 0;
+	}
+
+	while (remaining >= sizeof(block))
+	{
+		ProcessBlock(p);
+		p += sizeof(block);
+		remaining -= sizeof(block);
+	}
+
+	memcpy(block, p, remaining);
+	blockUsed = remaining;
+}
+
+std::string Sha1::Finish()
+{
+	const uint64_t bitLength(length * 8);
+	const unsigned char pad(0x80);
+	const unsigned char zero(0);
+	Update(&pad, 1);
+	while (blockUsed != 56)
+		Update(&zero, 1);
+
+	unsigned char lengthBytes[8];
+	unsigned int i;
+	for (i = 0; i < 8; i++)
+		lengthBytes[i] = static_cast<unsigned char>(bitLength >> (56 - 8 * i));
+	Update(lengthBytes, sizeof(lengthBytes));
+
+	std::string digest(20, '\0');
+	for (i = 0; i < 20; i++)
+		digest[i] = static_cast<char>(state[i / 4] >> (24 - 8 * (i % 4)));
+	return digest;
+}
+
+std::string Sha1::HashBlob(const std::string& contents)
+{
+	std::ostringstream header;
+	header << "blob " << contents.length();
+
+	Sha1 sha;
+	sha.Update(header.str().c_str(), header.str().length() + 1);// Includes the NUL
+	sha.Update(contents);
+	return sha.Finish();
+}
+
+void Sha1::ProcessBlock(const unsigned char* data)
+{
+	uint32_t w[80];
+	unsigned int i;
+	for (i = 0; i < 16; i++)
+		w[i] = (static_cast<uint32_t>(data[4 * i]) << 24) |
+			(static_cast<uint32_t>(data[4 * i + 1]) << 16) |
+			(static_cast<uint32_t>(data[4 * i + 2]) << 8) |
+			static_cast<uint32_t>(data[4 * i + 3]);
+	for (i = 16; i < 80; i++)
+		w[i] = RotateLeft(w[i - 3] ^ w[i - 8] ^ w[i - 14] ^ w[i - 16], 1);
+
+	uint32_t a(state[0]), b(state[1]), c(state[2]), d(state[3]), e(state[4]);
+	for (i = 0; i < 80; i++)
+	{
+		uint32_t f, k;
+		if (i < 20)
+		{
+			f = (b & c) | (~b & d);
+			k = 0x5A827999;
+		}
+		else if (i < 40)
+		{
+			f = b ^ c ^ d;
+			k = 0x6ED9EBA1;
+		}
+		else if (i < 60)
+		{
+			f = (b & c) | (b & d) | (c & d);
+			k = 0x8F1BBCDC;
+		}
+		else
+		{
+			f = b ^ c ^ d;
+			k = 0xCA62C1D6;
+		}
+
+		const uint32_t temp(RotateLeft(a, 5) + f + e + k + w[i]);
+		e = d;
+		d = c;
+		c = RotateLeft(b, 30);
+		b = a;
+		a = temp;
+	}
+
+	state[0] += a;
+	state[1] += b;
+	state[2] += c;
+	state[3] += d;
+	state[4] += e;
+}
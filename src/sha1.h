@@ -0,0 +1,37 @@
+// File:  sha1.h
+// Date:  10/18/2026
+// Auth:  agent
+// Desc:  SHA-1 digest, for computing git object IDs.
+
+#ifndef SHA1_H_
+#define SHA1_H_
+
+// Standard C++ headers
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+class Sha1
+{
+public:
+	Sha1();
+
+	void Update(const void* data, const size_t& length);
+	void Update(const std::string& data) { Update(data.data(), data.length()); }
+
+	// Returns the 20 byte digest; the object must not be updated afterwards
+	std::string Finish();
+
+	// ID of a blob with the given contents (raw bytes, not hex)
+	static std::string HashBlob(const std::string& contents);
+
+private:
+	uint32_t state[5];
+	uint64_t length;// [bytes]
+	unsigned char block[64];
+	size_t blockUsed;
+
+	void ProcessBlock(const unsigned char* data);
+};
+
+#endif// SHA1_H_
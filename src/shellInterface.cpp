@@ -1,69 +1,189 @@
 // File:  shellInterface.cpp
 // Date:  11/20/2015
 // Auth:  K. Loux
-// Desc:  Interface to system shell.
+// Desc:  Interface for running child processes.
 
 // Standard C/C++ headers
 #include <cstdlib>
 #include <sstream>
 #include <iostream>
 #include <cassert>
+#include <cerrno>
+#include <chrono>
+
+#ifndef _WIN32
+// POSIX headers
+#include <signal.h>
+#include <spawn.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#endif
 
 // Local headers
 #include "shellInterface.h"
+#include "performanceStats.h"
+#include "traceRecorder.h"
 
-const std::string ShellInterface::stderrToStdout(" 2>&1");
 #ifdef _WIN32
 #define popen _popen
 #define pclose _pclose
+const std::string ShellInterface::stderrToStdout("2>&1");
 const std::string ShellInterface::stdoutToNullFile("> nul");
 const std::string ShellInterface::stderrToNullFile("2> nul");
 const std::string ShellInterface::allToNullFile("> nul 2>&1");
 #else
-const std::string ShellInterface::stdoutToNullFile(" > /dev/null");
-const std::string ShellInterface::stderrToNullFile(" 2> /dev/null");
-const std::string ShellInterface::allToNullFile(" > /dev/null 2>&1");
+extern char **environ;
 #endif
 
 ShellInterface::ShellInterface()
 {
 	exitCode = 0;
-	cmdFile = NULL;
+	deadline = NoDeadline();
 }
 
-int ShellInterface::ExecuteCommand(const std::string& command,
+int ShellInterface::ExecuteCommand(const ArgumentList& arguments,
 	const RedirectFlags& f)
 {
-	std::string cmdString(command + BuildRedirectString(f));
-	exitCode = system(cmdString.c_str());
-#ifndef _WIN32
-	exitCode = WEXITSTATUS(exitCode);
-#endif
+	ProcessResult result;
+	ExecuteCommand(arguments, result, f);
 	return exitCode;
 }
 
-bool ShellInterface::ExecuteCommand(const std::string& command,
+bool ShellInterface::ExecuteCommand(const ArgumentList& arguments,
 	std::string& stdOut, const RedirectFlags& f)
 {
-	stdOut.clear();
-	std::string cmdString(command + BuildRedirectString(f));
+	ProcessResult result;
+	const bool started(ExecuteCommand(arguments, result, f));
+	stdOut.swap(result.stdOut);
+	return started;
+}
+
+bool ShellInterface::ExecuteCommand(const ArgumentList& arguments,
+	ProcessResult& result, const RedirectFlags& f)
+{
+	return ExecuteCommand(arguments, LineFunction(), result, f);
+}
+
+bool ShellInterface::ExecuteCommand(const ArgumentList& arguments,
+	const LineFunction& lineFunction, ProcessResult& result, const RedirectFlags& f)
+{
+	if (!TraceRecorder::IsEnabled())
+		return RunProcess(arguments, lineFunction, result, f);
+
+	std::string name, command;
+	DescribeCommand(arguments, name, command);
+
+	TraceRecorder::Span span("process", name);
+	const bool started(RunProcess(arguments, lineFunction, result, f));
+	span.AddArgument("command", command);
+	span.AddArgument("exitCode", static_cast<long long>(result.exitCode));
+	if (result.stoppedEarly)
+		span.AddArgument("stoppedEarly", 1LL);
+	if (result.timedOut)
+		span.AddArgument("timedOut", 1LL);
+	span.AddArgument("stdOutBytes", static_cast<long long>(result.stdOutBytes));
+	span.AddArgument("stdErrBytes", static_cast<long long>(result.stdErr.length()));
+	return started;
+}
+
+void ShellInterface::DescribeCommand(const ArgumentList& arguments,
+	std::string& name, std::string& commandLine)
+{
+	// Named for the program and its first non-option argument (the git
+	// subcommand)
+	name = arguments.empty() ? std::string() : arguments[0];
+	commandLine.clear();
+	unsigned int i;
+	for (i = 0; i < arguments.size(); i++)
+	{
+		if (i > 0 && name.find(' ') == std::string::npos &&
+			!arguments[i].empty() && arguments[i][0] != '-')
+			name.append(" " + arguments[i]);
+		commandLine.append((i > 0 ? " " : "") + arguments[i]);
+	}
+}
+
+bool ShellInterface::DeliverLines(std::string& buffer, const LineFunction& lineFunction)
+{
+	size_t start(0), end;
+	bool keepGoing(true);
+	while (keepGoing && (end = buffer.find('\n', start)) != std::string::npos)
+	{
+		keepGoing = lineFunction(buffer.substr(start, end - start));
+		start = end + 1;
+	}
+
+	buffer.erase(0, start);
+	return keepGoing;
+}
+
+#ifdef _WIN32
+bool ShellInterface::RunProcess(const ArgumentList& arguments,
+	const LineFunction& lineFunction, ProcessResult& result, const RedirectFlags& f)
+{
+	const std::chrono::steady_clock::time_point start(std::chrono::steady_clock::now());
+	result = ProcessResult();
 
-	assert(!cmdFile);
-	cmdFile = popen(cmdString.c_str(), "r");
+	std::string cmdString(BuildCommandLine(arguments) + BuildRedirectString(f));
+	PerformanceStats::CountProcess();
+	FILE* cmdFile = popen(cmdString.c_str(), "r");
 	if (!cmdFile)
+	{
+		exitCode = -1;
 		return false;
+	}
 
 	char buffer[4096];
-	buffer[0] = '\0';
-	while (std::fgets(buffer, sizeof(buffer), cmdFile))
-		stdOut.append(buffer);
+	size_t count;
+	while ((count = fread(buffer, 1, sizeof(buffer), cmdFile)) > 0)
+	{
+		result.stdOut.append(buffer, count);
+		result.stdOutBytes += count;
+
+		// There is no handle for terminating the child, so once we stop
+		// reading it is left to fail on its next write to the closed pipe
+		if (lineFunction && !DeliverLines(result.stdOut, lineFunction))
+		{
+			result.stoppedEarly = true;
+			break;
+		}
+	}
 
-	exitCode = pclose(cmdFile);
-	cmdFile = NULL;
+	if (lineFunction)
+	{
+		if (!result.stoppedEarly && !result.stdOut.empty())
+			lineFunction(result.stdOut);
+		result.stdOut.clear();
+	}
+
+	result.started = true;
+	result.exitCode = exitCode = pclose(cmdFile);
+	result.elapsedTime = std::chrono::duration<double>(
+		std::chrono::steady_clock::now() - start).count();
 
 	return true;
 }
 
+std::string ShellInterface::BuildCommandLine(const ArgumentList& arguments)
+{
+	std::string commandLine;
+	unsigned int i;
+	for (i = 0; i < arguments.size(); i++)
+	{
+		if (i > 0)
+			commandLine.append(" ");
+
+		if (arguments[i].find_first_of(" \t") == std::string::npos)
+			commandLine.append(arguments[i]);
+		else
+			commandLine.append("\"" + arguments[i] + "\"");
+	}
+
+	return commandLine;
+}
+
 std::string ShellInterface::BuildRedirectString(const RedirectFlags& f) const
 {
 	if (f == RedirectErrToOut)
@@ -78,3 +198,257 @@ std::string ShellInterface::BuildRedirectString(const RedirectFlags& f) const
 	assert(f == RedirectNone && "unknown combination of redirect flags");
 	return "";
 }
+#else
+bool ShellInterface::RunProcess(const ArgumentList& arguments,
+	const LineFunction& lineFunction, ProcessResult& result, const RedirectFlags& f)
+{
+	const std::chrono::steady_clock::time_point start(std::chrono::steady_clock::now());
+	result = ProcessResult();
+	exitCode = -1;
+
+	ChildProcess child;
+	if (!StartProcess(arguments, f, child, deadline))
+		return false;
+
+	// Drain both pipes together so neither one can fill and stall the child
+	pollfd fds[2];
+	fds[0].fd = child.stdOut;
+	fds[0].events = POLLIN;
+	fds[1].fd = child.stdErr;
+	fds[1].events = POLLIN;
+	std::string* buffers[2] = { &result.stdOut, &result.stdErr };
+
+	unsigned int i;
+	char buffer[65536];
+	while (fds[0].fd >= 0 || fds[1].fd >= 0)
+	{
+		const int pollResult(poll(fds, 2, EnforceDeadline(child, result)));
+		if (pollResult < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			break;
+		}
+		else if (pollResult == 0)
+			continue;
+
+		for (i = 0; i < 2; i++)
+		{
+			if (fds[i].fd < 0 || fds[i].revents == 0)
+				continue;
+
+			const ssize_t count(read(fds[i].fd, buffer, sizeof(buffer)));
+			if (count > 0)
+			{
+				buffers[i]->append(buffer, count);
+				if (i == 0)
+					result.stdOutBytes += count;
+			}
+			else if (count == 0 || errno != EINTR)
+			{
+				close(fds[i].fd);
+				fds[i].fd = -1;
+			}
+		}
+
+		// Once the caller has what it needs there is no point in waiting for
+		// the child to produce (or compute) the rest of its output
+		if (lineFunction && !result.stoppedEarly &&
+			!DeliverLines(result.stdOut, lineFunction))
+		{
+			result.stoppedEarly = true;
+			kill(child.pid, SIGTERM);
+			for (i = 0; i < 2; i++)
+			{
+				if (fds[i].fd >= 0)
+					close(fds[i].fd);
+				fds[i].fd = -1;
+			}
+		}
+	}
+
+	if (lineFunction)
+	{
+		if (!result.stoppedEarly && !result.stdOut.empty())
+			lineFunction(result.stdOut);// Final line had no newline
+		result.stdOut.clear();
+	}
+
+	// The child may still be running after closing its output
+	siginfo_t info;
+	info.si_pid = 0;
+	while (child.deadline != NoDeadline() && waitid(P_PID, child.pid, &info,
+		WEXITED | WNOHANG | WNOWAIT) == 0 && info.si_pid == 0)
+	{
+		const int wait(EnforceDeadline(child, result));
+		poll(NULL, 0, wait < 0 || wait > 10 ? 10 : wait);
+	}
+
+	KillRemainingGroup(child);
+
+	child.stdOut = fds[0].fd;
+	child.stdErr = fds[1].fd;
+	if (!WaitForProcess(child, exitCode))
+		return false;
+
+	result.started = true;
+	result.exitCode = exitCode;
+	result.elapsedTime = std::chrono::duration<double>(
+		std::chrono::steady_clock::now() - start).count();
+
+	return true;
+}
+
+bool ShellInterface::StartProcess(const ArgumentList& arguments,
+	const RedirectFlags& f, ChildProcess& child,
+	const Deadline& deadline)
+{
+	assert(!arguments.empty());
+	child = ChildProcess();
+
+	// Pipes must be close-on-exec so children started concurrently from
+	// other threads do not inherit our write ends and hold them open
+	int outPipe[2] = { -1, -1 };
+	int errPipe[2] = { -1, -1 };
+	const bool captureOut((f & RedirectOutToNull) == 0);
+	const bool captureErr((f & (RedirectErrToNull | RedirectErrToOut)) == 0);
+	if (captureOut && pipe2(outPipe, O_CLOEXEC) != 0)
+		return false;
+	if (captureErr && pipe2(errPipe, O_CLOEXEC) != 0)
+	{
+		close(outPipe[0]);
+		close(outPipe[1]);
+		return false;
+	}
+
+	posix_spawn_file_actions_t actions;
+	posix_spawn_file_actions_init(&actions);
+	posix_spawn_file_actions_addopen(&actions, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+
+	if (captureOut)
+		posix_spawn_file_actions_adddup2(&actions, outPipe[1], STDOUT_FILENO);
+	else
+		posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, "/dev/null", O_WRONLY, 0);
+
+	if (f & RedirectErrToOut)
+		posix_spawn_file_actions_adddup2(&actions, STDOUT_FILENO, STDERR_FILENO);
+	else if (f & RedirectErrToNull)
+		posix_spawn_file_actions_addopen(&actions, STDERR_FILENO, "/dev/null", O_WRONLY, 0);
+	else
+		posix_spawn_file_actions_adddup2(&actions, errPipe[1], STDERR_FILENO);
+
+	posix_spawnattr_t attributes;
+	posix_spawnattr_init(&attributes);
+	short flags(0);
+#ifdef POSIX_SPAWN_USEVFORK
+	flags |= POSIX_SPAWN_USEVFORK;
+#endif
+
+	// Only when there is a deadline, since a child outside the terminal's
+	// foreground group can't prompt for credentials
+	if (deadline != NoDeadline())
+	{
+		flags |= POSIX_SPAWN_SETPGROUP;
+		posix_spawnattr_setpgroup(&attributes, 0);
+	}
+	posix_spawnattr_setflags(&attributes, flags);
+
+	std::vector<char*> argv(arguments.size() + 1, NULL);
+	unsigned int i;
+	for (i = 0; i < arguments.size(); i++)
+		argv[i] = const_cast<char*>(arguments[i].c_str());
+
+	PerformanceStats::CountProcess();
+	pid_t pid;
+	const int spawnError(posix_spawnp(&pid, argv[0], &actions, &attributes,
+		argv.data(), environ));
+	posix_spawn_file_actions_destroy(&actions);
+	posix_spawnattr_destroy(&attributes);
+
+	if (outPipe[1] >= 0)
+		close(outPipe[1]);
+	if (errPipe[1] >= 0)
+		close(errPipe[1]);
+
+	if (spawnError != 0)
+	{
+		if (outPipe[0] >= 0)
+			close(outPipe[0]);
+		if (errPipe[0] >= 0)
+			close(errPipe[0]);
+		return false;
+	}
+
+	child.pid = pid;
+	child.deadline = deadline;
+	child.stdOut = outPipe[0];
+	child.stdErr = errPipe[0];
+
+	return true;
+}
+
+bool ShellInterface::WaitForProcess(ChildProcess& child, int& exitCode)
+{
+	if (child.stdOut >= 0)
+		close(child.stdOut);
+	if (child.stdErr >= 0)
+		close(child.stdErr);
+	child.stdOut = child.stdErr = -1;
+
+	exitCode = -1;
+	if (child.pid <= 0)
+		return false;
+
+	int status;
+	while (waitpid(child.pid, &status, 0) < 0)
+	{
+		if (errno != EINTR)
+			return false;
+	}
+	child.pid = -1;
+
+	if (WIFEXITED(status))
+		exitCode = WEXITSTATUS(status);
+	else if (WIFSIGNALED(status))
+		exitCode = 128 + WTERMSIG(status);
+
+	return true;
+}
+
+int ShellInterface::EnforceDeadline(ChildProcess& child, ProcessResult& result)
+{
+	if (child.deadline == NoDeadline() || child.pid <= 0)
+		return -1;
+
+	const std::chrono::steady_clock::time_point now(std::chrono::steady_clock::now());
+	if (now < child.deadline)
+	{
+		// Rounded up so we don't wake just before the deadline
+		return static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+			child.deadline - now).count()) + 1;
+	}
+
+	if (child.terminated)
+	{
+		kill(-child.pid, SIGKILL);
+		child.deadline = NoDeadline();
+		return -1;
+	}
+
+	// Stopped children (e.g. waiting to read from the terminal) must be
+	// continued before they can act on SIGTERM
+	const std::chrono::seconds gracePeriod(2);
+	kill(-child.pid, SIGTERM);
+	kill(-child.pid, SIGCONT);
+	child.terminated = true;
+	child.deadline = now + gracePeriod;
+	result.timedOut = true;
+	return std::chrono::duration_cast<std::chrono::milliseconds>(gracePeriod).count();
+}
+
+void ShellInterface::KillRemainingGroup(const ChildProcess& child)
+{
+	if (child.terminated && child.pid > 0)
+		kill(-child.pid, SIGKILL);
+}
+#endif
@@ -1,13 +1,16 @@
 // File:  shellInterface.h
 // Date:  11/20/2015
 // Auth:  K. Loux
-// Desc:  Interface to system shell.
+// Desc:  Interface for running child processes.
 
 #ifndef SHELL_INTERFACE_H_
 #define SHELL_INTERFACE_H_
 
 // Standard C/C++ headers
 #include <string>
+#include <vector>
+#include <functional>
+#include <chrono>
 #include <stdio.h>
 
 class ShellInterface
@@ -15,6 +18,8 @@ class ShellInterface
 public:
 	ShellInterface();
 
+	typedef std::vector<std::string> ArgumentList;
+
 	enum RedirectFlags
 	{
 		RedirectNone = 0,
@@ -24,23 +29,103 @@ public:
 		RedirectAllToNull = 6
 	};
 
-	int ExecuteCommand(const std::string& command,
+	struct ProcessResult
+	{
+		ProcessResult() : started(false), stoppedEarly(false), timedOut(false),
+			exitCode(-1), stdOutBytes(0), elapsedTime(0.0) {}
+
+		bool started;
+		bool stoppedEarly;// The line function asked for no more output
+		bool timedOut;// Terminated because the deadline passed
+		int exitCode;
+		std::string stdOut;// Empty if a line function was given
+		std::string stdErr;
+		size_t stdOutBytes;
+		double elapsedTime;// [sec]
+	};
+
+	// Receives each line of standard output (without the newline) as it
+	// arrives; returning false terminates the child
+	typedef std::function<bool(const std::string& line)> LineFunction;
+
+	// The first argument is the program name, which is looked up on the path.
+	// No shell is involved, so arguments are never re-interpreted or quoted.
+	bool ExecuteCommand(const ArgumentList& arguments, ProcessResult& result,
+		const RedirectFlags& f = RedirectNone);
+	bool ExecuteCommand(const ArgumentList& arguments, const LineFunction& lineFunction,
+		ProcessResult& result, const RedirectFlags& f = RedirectNone);
+
+	int ExecuteCommand(const ArgumentList& arguments,
 		const RedirectFlags& f = RedirectAllToNull);
-	bool ExecuteCommand(const std::string& command, std::string& stdOut,
+	bool ExecuteCommand(const ArgumentList& arguments, std::string& stdOut,
 		const RedirectFlags& f = RedirectNone);
 
 	int GetExitCode() const { return exitCode; }
 
+	// Children still running at the deadline are terminated, along with
+	// anything they started (not supported on Windows)
+	typedef std::chrono::steady_clock::time_point Deadline;
+	static Deadline NoDeadline() { return Deadline::max(); }
+	void SetDeadline(const Deadline& d) { deadline = d; }
+
+	// Short name (program and subcommand) and full command line for traces
+	static void DescribeCommand(const ArgumentList& arguments, std::string& name,
+		std::string& commandLine);
+
+#ifndef _WIN32
+	// A child that has been started but not yet reaped, for callers that
+	// read its output themselves
+	struct ChildProcess
+	{
+		ChildProcess() : pid(-1), stdOut(-1), stdErr(-1),
+			deadline(NoDeadline()), terminated(false) {}
+
+		int pid;
+		int stdOut;
+		int stdErr;
+
+		// Children with a deadline lead their own process group so the whole
+		// group can be signalled
+		Deadline deadline;
+		bool terminated;// SIGTERM sent; deadline is now the time for SIGKILL
+	};
+
+	static bool StartProcess(const ArgumentList& arguments,
+		const RedirectFlags& f, ChildProcess& child,
+		const Deadline& deadline = NoDeadline());
+
+	// Signals the child's process group if its deadline has passed; returns
+	// the number of milliseconds until it next needs to be called, or -1
+	static int EnforceDeadline(ChildProcess& child, ProcessResult& result);
+
+	// Once a terminated child has exited, but before it is reaped (so its
+	// process group ID can't be reused), kills anything it left running
+	static void KillRemainingGroup(const ChildProcess& child);
+
+	// Closes any pipes that are still open, then reaps the child
+	static bool WaitForProcess(ChildProcess& child, int& exitCode);
+#endif
+
 private:
+	int exitCode;
+	Deadline deadline;
+
+	bool RunProcess(const ArgumentList& arguments, const LineFunction& lineFunction,
+		ProcessResult& result, const RedirectFlags& f);
+
+	// Hands complete lines from the buffer to the line function and removes
+	// them; returns false if the line function asked to stop
+	static bool DeliverLines(std::string& buffer, const LineFunction& lineFunction);
+
+#ifdef _WIN32
 	static const std::string stderrToStdout;
 	static const std::string stdoutToNullFile;
 	static const std::string stderrToNullFile;
 	static const std::string allToNullFile;
 
-	FILE* cmdFile;
-	int exitCode;
-
 	std::string BuildRedirectString(const RedirectFlags& f) const;
+	static std::string BuildCommandLine(const ArgumentList& arguments);
+#endif
 };
 
-#endif// SHELL_INTERFACE_H_
\ No newline at end of file
+#endif// SHELL_INTERFACE_H_
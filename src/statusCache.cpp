@@ -0,0 +1,563 @@
+// File:  statusCache.cpp
+// Date:  10/18/2026
+// Auth:  agent
+// Desc:  On-disk cache of remotes, refs and comparisons from previous runs.
+
+// Standard C/C++ headers
+#include <cstring>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <algorithm>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+// Windows headers
+#include "windirent.h"// Local, but 3rd party
+#else
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
+
+// Local headers
+#include "statusCache.h"
+#include "refStore.h"
+
+// File layout:
+//   Header:            magic, version, entry count, comparison count
+//   Entry table:       (path hash, offset, length), sorted by path hash
+//   Comparison table:  (key, ahead << 32 | behind), sorted by key
+//   Entry records:     path, fingerprint, branches, tags, remotes
+static const char cacheMagic[8] = { 'G', 'U', 'C', 'A', 'C', 'H', 'E', '\0' };
+static const uint32_t cacheVersion(2);
+static const size_t headerSize(24);
+static const size_t entrySize(24);
+static const size_t comparisonSize(16);
+
+namespace
+{
+
+template <typename T>
+T ReadValue(const char* p)
+{
+	T value;
+	memcpy(&value, p, sizeof(T));
+	return value;
+}
+
+template <typename T>
+void WriteValue(std::string& s, const T& value)
+{
+	s.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+void WriteString(std::string& s, const std::string& value)
+{
+	WriteValue<uint32_t>(s, static_cast<uint32_t>(value.length()));
+	s.append(value);
+}
+
+// Works for both branches and tags; hashes are stored as hex so the file
+// format doesn't depend on how they're held in memory
+template <typename T>
+void WriteRefs(std::string& s, const std::vector<T>& refs)
+{
+	WriteValue<uint32_t>(s, static_cast<uint32_t>(refs.size()));
+	unsigned int i;
+	for (i = 0; i < refs.size(); i++)
+	{
+		WriteString(s, refs[i].name);
+		WriteString(s, refs[i].hash.ToHex());
+	}
+}
+
+// Bounds-checked reading of a single record
+class RecordReader
+{
+public:
+	RecordReader(const char* data, const uint32_t& length)
+		: position(data), end(data + length), ok(true) {}
+
+	bool IsOK() const { return ok; }
+
+	template <typename T>
+	T Read()
+	{
+		if (!ok || end - position < static_cast<ptrdiff_t>(sizeof(T)))
+		{
+			ok = false;
+			return T();
+		}
+
+		T value(ReadValue<T>(position));
+		position += sizeof(T);
+		return value;
+	}
+
+	std::string ReadString()
+	{
+		const uint32_t length(Read<uint32_t>());
+		if (!ok || end - position < static_cast<ptrdiff_t>(length))
+		{
+			ok = false;
+			return std::string();
+		}
+
+		std::string value(position, length);
+		position += length;
+		return value;
+	}
+
+	std::vector<GitInterface::BranchInfo> ReadBranches()
+	{
+		const uint32_t count(Read<uint32_t>());
+		std::vector<GitInterface::BranchInfo> branches;
+		unsigned int i;
+		for (i = 0; i < count && ok; i++)
+		{
+			GitInterface::BranchInfo branch;
+			branch.name = NameTable::Intern(ReadString());
+			branch.hash = ObjectId::FromHex(ReadString());
+			branches.push_back(branch);
+		}
+
+		return branches;
+	}
+
+	std::vector<GitInterface::TagInfo> ReadTags()
+	{
+		const uint32_t count(Read<uint32_t>());
+		std::vector<GitInterface::TagInfo> tags;
+		unsigned int i;
+		for (i = 0; i < count && ok; i++)
+		{
+			GitInterface::TagInfo tag;
+			tag.name = ReadString();
+			tag.hash = ObjectId::FromHex(ReadString());
+			tags.push_back(tag);
+		}
+
+		return tags;
+	}
+
+private:
+	const char* position;
+	const char* const end;
+	bool ok;
+};
+
+void AddToFingerprint(const std::string& fileName, std::vector<uint64_t>& values)
+{
+	struct stat info;
+	if (stat(fileName.c_str(), &info) != 0)
+	{
+		values.push_back(0);
+		return;
+	}
+
+	values.push_back(static_cast<uint64_t>(info.st_dev));
+	values.push_back(static_cast<uint64_t>(info.st_ino));
+	values.push_back(static_cast<uint64_t>(info.st_size));
+#if defined(__linux__)
+	values.push_back(static_cast<uint64_t>(info.st_mtim.tv_sec));
+	values.push_back(static_cast<uint64_t>(info.st_mtim.tv_nsec));
+#elif defined(__APPLE__)
+	values.push_back(static_cast<uint64_t>(info.st_mtimespec.tv_sec));
+	values.push_back(static_cast<uint64_t>(info.st_mtimespec.tv_nsec));
+#else
+	values.push_back(static_cast<uint64_t>(info.st_mtime));
+#endif
+}
+
+// Ref updates are written to a lock file and renamed into place, which
+// changes the modification time of the directory containing the ref
+void AddDirectoryTreeToFingerprint(const std::string& directory,
+	std::vector<uint64_t>& values)
+{
+	AddToFingerprint(directory, values);
+
+	DIR *dp(opendir(directory.c_str()));
+	if (!dp)
+		return;
+
+	std::vector<std::string> subdirectories;
+	dirent *d;
+	while ((d = readdir(dp)) != NULL)
+	{
+		if (d->d_type != DT_DIR || strcmp(d->d_name, ".") == 0 ||
+			strcmp(d->d_name, "..") == 0)
+			continue;
+		subdirectories.push_back(d->d_name);
+	}
+	closedir(dp);
+
+	std::sort(subdirectories.begin(), subdirectories.end());
+	unsigned int i;
+	for (i = 0; i < subdirectories.size(); i++)
+		AddDirectoryTreeToFingerprint(directory + subdirectories[i] + "/", values);
+}
+
+}
+
+StatusCache::StatusCache(const std::string& fileName) : fileName(fileName)
+{
+	mappedData = NULL;
+	mappedSize = 0;
+	entryCount = 0;
+	comparisonCount = 0;
+	entryTable = NULL;
+	comparisonTable = NULL;
+}
+
+StatusCache::~StatusCache()
+{
+	Unmap();
+}
+
+void StatusCache::Unmap()
+{
+#ifdef _WIN32
+	delete [] mappedData;
+#else
+	if (mappedData)
+		munmap(const_cast<char*>(mappedData), mappedSize);
+#endif
+	mappedData = NULL;
+	mappedSize = 0;
+	entryCount = 0;
+	comparisonCount = 0;
+}
+
+bool StatusCache::Load()
+{
+	Unmap();
+
+#ifdef _WIN32
+	std::ifstream file(fileName.c_str(), std::ios::binary);
+	if (!file.is_open())
+		return false;
+
+	std::ostringstream ss;
+	ss << file.rdbuf();
+	const std::string contents(ss.str());
+	char* buffer(new char[contents.length()]);
+	memcpy(buffer, contents.c_str(), contents.length());
+	mappedData = buffer;
+	mappedSize = contents.length();
+#else
+	const int fd(open(fileName.c_str(), O_RDONLY | O_CLOEXEC));
+	if (fd < 0)
+		return false;
+
+	struct stat info;
+	if (fstat(fd, &info) != 0 || info.st_size < static_cast<off_t>(headerSize))
+	{
+		close(fd);
+		return false;
+	}
+
+	void* data(mmap(NULL, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0));
+	close(fd);
+	if (data == MAP_FAILED)
+		return false;
+
+	mappedData = static_cast<const char*>(data);
+	mappedSize = info.st_size;
+#endif
+
+	if (mappedSize < headerSize ||
+		memcmp(mappedData, cacheMagic, sizeof(cacheMagic)) != 0 ||
+		ReadValue<uint32_t>(mappedData + 8) != cacheVersion)
+	{
+		Unmap();
+		return false;
+	}
+
+	entryCount = ReadValue<uint32_t>(mappedData + 12);
+	comparisonCount = ReadValue<uint32_t>(mappedData + 16);
+	if (headerSize + static_cast<uint64_t>(entryCount) * entrySize +
+		static_cast<uint64_t>(comparisonCount) * comparisonSize > mappedSize)
+	{
+		Unmap();
+		return false;
+	}
+
+	entryTable = mappedData + headerSize;
+	comparisonTable = entryTable + entryCount * entrySize;
+	return true;
+}
+
+bool StatusCache::Save()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	// Keep entries for repositories we didn't visit this time (they may be
+	// under a different search path), but replace those we did
+	std::vector<std::pair<uint64_t, std::string> > records;
+	unsigned int i;
+	for (i = 0; i < entryCount; i++)
+	{
+		const char* entry(entryTable + i * entrySize);
+		const uint64_t pathHash(ReadValue<uint64_t>(entry));
+		const uint64_t offset(ReadValue<uint64_t>(entry + 8));
+		const uint32_t length(ReadValue<uint32_t>(entry + 16));
+		if (updatedEntries.find(pathHash) != updatedEntries.end() ||
+			offset + length > mappedSize)
+			continue;
+		records.push_back(std::make_pair(pathHash,
+			std::string(mappedData + offset, length)));
+	}
+
+	std::map<uint64_t, std::string>::const_iterator it;
+	for (it = updatedEntries.begin(); it != updatedEntries.end(); ++it)
+		records.push_back(*it);
+	std::sort(records.begin(), records.end());
+
+	std::string header(cacheMagic, sizeof(cacheMagic));
+	WriteValue<uint32_t>(header, cacheVersion);
+	WriteValue<uint32_t>(header, static_cast<uint32_t>(records.size()));
+	WriteValue<uint32_t>(header, static_cast<uint32_t>(usedComparisons.size()));
+	WriteValue<uint32_t>(header, 0);
+
+	std::string tables;
+	uint64_t offset(headerSize + records.size() * entrySize +
+		usedComparisons.size() * comparisonSize);
+	for (i = 0; i < records.size(); i++)
+	{
+		WriteValue<uint64_t>(tables, records[i].first);
+		WriteValue<uint64_t>(tables, offset);
+		WriteValue<uint32_t>(tables, static_cast<uint32_t>(records[i].second.length()));
+		WriteValue<uint32_t>(tables, 0);
+		offset += records[i].second.length();
+	}
+
+	// Comparisons not used this run are dropped so the table can't grow forever
+	std::map<uint64_t, uint64_t>::const_iterator comparison;
+	for (comparison = usedComparisons.begin(); comparison != usedComparisons.end(); ++comparison)
+	{
+		WriteValue<uint64_t>(tables, comparison->first);
+		WriteValue<uint64_t>(tables, comparison->second);
+	}
+
+	// Write a new file and rename it over the old one so a concurrent reader
+	// never sees a partial file
+	const std::string tempFileName(fileName + ".tmp");
+	{
+		std::ofstream file(tempFileName.c_str(), std::ios::binary | std::ios::trunc);
+		if (!file.is_open())
+			return false;
+
+		file.write(header.c_str(), header.length());
+		file.write(tables.c_str(), tables.length());
+		for (i = 0; i < records.size(); i++)
+			file.write(records[i].second.c_str(), records[i].second.length());
+
+		if (!file.good())
+			return false;
+	}
+
+#ifdef _WIN32
+	remove(fileName.c_str());
+#endif
+	return rename(tempFileName.c_str(), fileName.c_str()) == 0;
+}
+
+bool StatusCache::FindEntry(const uint64_t& pathHash, const char*& record,
+	uint32_t& length) const
+{
+	uint32_t low(0), high(entryCount);
+	while (low < high)
+	{
+		const uint32_t middle(low + (high - low) / 2);
+		const char* entry(entryTable + middle * entrySize);
+		const uint64_t value(ReadValue<uint64_t>(entry));
+		if (value < pathHash)
+			low = middle + 1;
+		else if (value > pathHash)
+			high = middle;
+		else
+		{
+			const uint64_t offset(ReadValue<uint64_t>(entry + 8));
+			length = ReadValue<uint32_t>(entry + 16);
+			if (offset + length > mappedSize)
+				return false;
+			record = mappedData + offset;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool StatusCache::FindComparison(const uint64_t& key, uint64_t& counts) const
+{
+	uint32_t low(0), high(comparisonCount);
+	while (low < high)
+	{
+		const uint32_t middle(low + (high - low) / 2);
+		const char* entry(comparisonTable + middle * comparisonSize);
+		const uint64_t value(ReadValue<uint64_t>(entry));
+		if (value < key)
+			low = middle + 1;
+		else if (value > key)
+			high = middle;
+		else
+		{
+			counts = ReadValue<uint64_t>(entry + 8);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool StatusCache::Lookup(const std::string& path, const uint64_t& fingerprint,
+	GitInterface::RepositoryInfo& info) const
+{
+	const uint64_t pathHash(Hash(path));
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		std::map<uint64_t, std::string>::const_iterator it(updatedEntries.find(pathHash));
+		if (it != updatedEntries.end())
+			return Deserialize(it->second.c_str(),
+				static_cast<uint32_t>(it->second.length()), path, fingerprint, info);
+	}
+
+	const char* record;
+	uint32_t length;
+	if (!FindEntry(pathHash, record, length))
+		return false;
+	return Deserialize(record, length, path, fingerprint, info);
+}
+
+void StatusCache::Store(const std::string& path, const uint64_t& fingerprint,
+	const GitInterface::RepositoryInfo& info)
+{
+	const std::string record(Serialize(path, fingerprint, info));
+	std::lock_guard<std::mutex> lock(mutex);
+	updatedEntries[Hash(path)] = record;
+}
+
+bool StatusCache::LookupComparison(const std::string& localHash,
+	const std::string& remoteHash, GitInterface::RepositoryStatus& status)
+{
+	const uint64_t key(Hash(remoteHash, Hash(localHash + "...")));
+	uint64_t counts;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		std::map<uint64_t, uint64_t>::const_iterator it(usedComparisons.find(key));
+		if (it != usedComparisons.end())
+			counts = it->second;
+		else if (FindComparison(key, counts))
+			usedComparisons[key] = counts;
+		else
+			return false;
+	}
+
+	status.ahead = static_cast<unsigned int>(counts >> 32);
+	status.behind = static_cast<unsigned int>(counts & 0xFFFFFFFF);
+	return true;
+}
+
+void StatusCache::StoreComparison(const std::string& localHash,
+	const std::string& remoteHash, const GitInterface::RepositoryStatus& status)
+{
+	const uint64_t key(Hash(remoteHash, Hash(localHash + "...")));
+	std::lock_guard<std::mutex> lock(mutex);
+	usedComparisons[key] = (static_cast<uint64_t>(status.ahead) << 32) | status.behind;
+}
+
+uint64_t StatusCache::ComputeFingerprint(const std::string& path)
+{
+	std::string gitDirectory, commonDirectory;
+	if (!RefStore::FindGitDirectory(path, gitDirectory, commonDirectory))
+		return 0;
+
+	std::vector<uint64_t> values;
+	AddToFingerprint(gitDirectory + "index", values);
+	AddToFingerprint(gitDirectory + "HEAD", values);
+	AddToFingerprint(gitDirectory + "FETCH_HEAD", values);
+	AddToFingerprint(commonDirectory + "packed-refs", values);
+	AddToFingerprint(commonDirectory + "config", values);
+	AddDirectoryTreeToFingerprint(commonDirectory + "refs/", values);
+
+	return Hash(values.data(), values.size() * sizeof(uint64_t), Hash(path));
+}
+
+// FNV-1a
+uint64_t StatusCache::Hash(const std::string& s, uint64_t hash)
+{
+	return Hash(s.c_str(), s.length(), hash);
+}
+
+uint64_t StatusCache::Hash(const void* data, const size_t& size, uint64_t hash)
+{
+	const unsigned char* bytes(static_cast<const unsigned char*>(data));
+	size_t i;
+	for (i = 0; i < size; i++)
+	{
+		hash ^= bytes[i];
+		hash *= 1099511628211ULL;
+	}
+
+	return hash;
+}
+
+std::string StatusCache::Serialize(const std::string& path,
+	const uint64_t& fingerprint, const GitInterface::RepositoryInfo& info)
+{
+	std::string record;
+	WriteString(record, path);
+	WriteValue<uint64_t>(record, fingerprint);
+
+	WriteRefs(record, info.branches);
+	WriteRefs(record, info.tags);
+
+	WriteValue<uint32_t>(record, static_cast<uint32_t>(info.remotes.size()));
+	unsigned int i;
+	for (i = 0; i < info.remotes.size(); i++)
+	{
+		WriteString(record, info.remotes[i].name);
+		WriteString(record, info.remotes[i].url);
+		WriteRefs(record, info.remotes[i].branches);
+	}
+
+	return record;
+}
+
+bool StatusCache::Deserialize(const char* data, const uint32_t& length,
+	const std::string& path, const uint64_t& fingerprint,
+	GitInterface::RepositoryInfo& info)
+{
+	RecordReader reader(data, length);
+
+	// Path is stored to protect against hash collisions
+	if (reader.ReadString().compare(path) != 0 ||
+		reader.Read<uint64_t>() != fingerprint)
+		return false;
+
+	GitInterface::RepositoryInfo cached;
+	cached.isGitRepository = true;
+	cached.branches = reader.ReadBranches();
+	cached.tags = reader.ReadTags();
+
+	const uint32_t remoteCount(reader.Read<uint32_t>());
+	unsigned int i;
+	for (i = 0; i < remoteCount && reader.IsOK(); i++)
+	{
+		GitInterface::RemoteInfo remote;
+		remote.name = NameTable::Intern(reader.ReadString());
+		remote.url = reader.ReadString();
+		remote.branches = reader.ReadBranches();
+		cached.remotes.push_back(remote);
+	}
+
+	if (!reader.IsOK())
+		return false;
+
+	info = cached;
+	return true;
+}
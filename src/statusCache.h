@@ -0,0 +1,84 @@
+// File:  statusCache.h
+// Date:  10/18/2026
+// Auth:  agent
+// Desc:  On-disk cache of remotes, refs and ahead/behind counts from previous
+//        runs.  The file is memory-mapped and only the entries that are
+//        looked up are decoded.  Working tree status isn't cached, since
+//        edits to the working tree don't change anything the fingerprint
+//        covers.
+
+#ifndef STATUS_CACHE_H_
+#define STATUS_CACHE_H_
+
+// Standard C++ headers
+#include <string>
+#include <map>
+#include <mutex>
+#include <cstdint>
+
+// Local headers
+#include "gitInterface.h"
+
+class StatusCache
+{
+public:
+	explicit StatusCache(const std::string& fileName);
+	~StatusCache();
+
+	bool Load();
+	bool Save();
+
+	// Returns true if the cached entry for path was stored with the same
+	// fingerprint (i.e. nothing in .git has changed since); only the remotes,
+	// branches and tags are filled in
+	bool Lookup(const std::string& path, const uint64_t& fingerprint,
+		GitInterface::RepositoryInfo& info) const;
+	void Store(const std::string& path, const uint64_t& fingerprint,
+		const GitInterface::RepositoryInfo& info);
+
+	// The ahead/behind counts between two commits never change, so these are
+	// keyed only by the object IDs
+	bool LookupComparison(const std::string& localHash,
+		const std::string& remoteHash, GitInterface::RepositoryStatus& status);
+	void StoreComparison(const std::string& localHash,
+		const std::string& remoteHash, const GitInterface::RepositoryStatus& status);
+
+	// Combines the identity and modification times of the files and
+	// directories git updates whenever refs, the index or remotes change
+	static uint64_t ComputeFingerprint(const std::string& path);
+
+private:
+	const std::string fileName;
+
+	// Memory-mapped contents of the file loaded at startup
+	const char* mappedData;
+	size_t mappedSize;
+	uint32_t entryCount;
+	uint32_t comparisonCount;
+	const char* entryTable;
+	const char* comparisonTable;
+
+	// Entries created or looked up during this run
+	mutable std::mutex mutex;
+	std::map<uint64_t, std::string> updatedEntries;// path hash -> record
+	std::map<uint64_t, uint64_t> usedComparisons;// key -> packed counts
+
+	void Unmap();
+	bool FindEntry(const uint64_t& pathHash, const char*& record,
+		uint32_t& length) const;
+	bool FindComparison(const uint64_t& key, uint64_t& counts) const;
+
+	static uint64_t Hash(const std::string& s, uint64_t hash = 14695981039346656037ULL);
+	static uint64_t Hash(const void* data, const size_t& size, uint64_t hash);
+
+	static std::string Serialize(const std::string& path,
+		const uint64_t& fingerprint, const GitInterface::RepositoryInfo& info);
+	static bool Deserialize(const char* data, const uint32_t& length,
+		const std::string& path, const uint64_t& fingerprint,
+		GitInterface::RepositoryInfo& info);
+
+	StatusCache(const StatusCache&);
+	StatusCache& operator=(const StatusCache&);
+};
+
+#endif// STATUS_CACHE_H_
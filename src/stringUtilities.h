@@ -319,6 +319,52 @@ static inline std::wstring Trim(const std::wstring &s)
 	return Trim(s2);
 }
 
+//==========================================================================
+// Class:			None
+// Function:		EscapeJson
+//
+// Description:		Escapes a string for use inside a JSON string literal.
+//
+// Input Arguments:
+//		s	= const std::string&
+//
+// Output Arguments:
+//		None
+//
+// Return Value:
+//		std::string
+//
+// Exception Safety:
+//		Strong
+//
+//==========================================================================
+static inline std::string EscapeJson(const std::string &s)
+{
+	const char hexDigits[] = "0123456789abcdef";
+	std::string escaped;
+	escaped.reserve(s.length());
+	unsigned int i;
+	for (i = 0; i < s.length(); i++)
+	{
+		const unsigned char c(s[i]);
+		if (c == '"' || c == '\\')
+		{
+			escaped.push_back('\\');
+			escaped.push_back(c);
+		}
+		else if (c < 0x20)
+		{
+			escaped.append("\\u00");
+			escaped.push_back(hexDigits[c >> 4]);
+			escaped.push_back(hexDigits[c & 0xf]);
+		}
+		else
+			escaped.push_back(c);
+	}
+
+	return escaped;
+}
+
 }
 
 #endif// STRING_UTILITIES_H_
\ No newline at end of file
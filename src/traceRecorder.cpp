@@ -0,0 +1,164 @@
+// File:  traceRecorder.cpp
+// Date:  10/18/2026
+// Auth:  agent
+// Desc:  Records timed spans in Chrome's trace event format.
+
+// Standard C/C++ headers
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+
+// Local headers
+#include "traceRecorder.h"
+#include "stringUtilities.h"
+
+bool TraceRecorder::enabled(false);
+std::chrono::steady_clock::time_point TraceRecorder::startTime;
+
+namespace
+{
+
+struct Event
+{
+	const char* category;
+	std::string name;
+	std::string arguments;
+	long long start;// [ns]
+	long long duration;// [ns]
+};
+
+// Each thread appends to its own buffer, so the only contention on a
+// buffer's mutex is with Write
+struct ThreadBuffer
+{
+	unsigned int id;
+	std::mutex mutex;
+	std::vector<Event> events;
+};
+
+std::mutex buffersMutex;
+std::vector<std::unique_ptr<ThreadBuffer> > buffers;
+thread_local ThreadBuffer* threadBuffer(NULL);
+
+ThreadBuffer& GetThreadBuffer()
+{
+	if (!threadBuffer)
+	{
+		std::lock_guard<std::mutex> lock(buffersMutex);
+		buffers.push_back(std::unique_ptr<ThreadBuffer>(new ThreadBuffer));
+		threadBuffer = buffers.back().get();
+		threadBuffer->id = buffers.size();
+	}
+
+	return *threadBuffer;
+}
+
+void WriteTime(std::ostream& out, const long long& nanoseconds)
+{
+	// Microseconds, keeping nanosecond resolution
+	char s[32];
+	snprintf(s, sizeof(s), "%lld.%03lld", nanoseconds / 1000, nanoseconds % 1000);
+	out << s;
+}
+
+}
+
+void TraceRecorder::Enable()
+{
+	enabled = true;
+	startTime = std::chrono::steady_clock::now();
+
+	// Makes the calling thread the first one listed
+	GetThreadBuffer();
+}
+
+TraceRecorder::Span::Span(const char* category, const std::string& name)
+	: active(enabled), category(category), start(std::chrono::steady_clock::now())
+{
+	if (active)
+		this->name = name;
+}
+
+TraceRecorder::Span::~Span()
+{
+	if (!active)
+		return;
+
+	const std::chrono::steady_clock::time_point end(std::chrono::steady_clock::now());
+	Event event;
+	event.category = category;
+	event.name.swap(name);
+	event.arguments.swap(arguments);
+	event.start = std::chrono::duration_cast<std::chrono::nanoseconds>(
+		start - startTime).count();
+	event.duration = std::chrono::duration_cast<std::chrono::nanoseconds>(
+		end - start).count();
+	ThreadBuffer& buffer(GetThreadBuffer());
+	std::lock_guard<std::mutex> lock(buffer.mutex);
+	buffer.events.push_back(std::move(event));
+}
+
+void TraceRecorder::Span::AddArgument(const char* key, const std::string& value)
+{
+	if (!active)
+		return;
+
+	if (!arguments.empty())
+		arguments.append(",");
+	arguments.append("\"" + EscapeJson(key) + "\":\"" + EscapeJson(value) + "\"");
+}
+
+void TraceRecorder::Span::AddArgument(const char* key, const long long& value)
+{
+	if (!active)
+		return;
+
+	std::ostringstream ss;
+	if (!arguments.empty())
+		ss << ",";
+	ss << "\"" << EscapeJson(key) << "\":" << value;
+	arguments.append(ss.str());
+}
+
+bool TraceRecorder::Write(const std::string& fileName)
+{
+	std::ofstream file(fileName.c_str());
+	if (!file.is_open())
+		return false;
+
+	std::lock_guard<std::mutex> lock(buffersMutex);
+	file << "{\"traceEvents\":[\n";
+	bool first(true);
+	unsigned int i, j;
+	for (i = 0; i < buffers.size(); i++)
+	{
+		ThreadBuffer& buffer(*buffers[i]);
+		std::lock_guard<std::mutex> bufferLock(buffer.mutex);
+		if (!first)
+			file << ",\n";
+		first = false;
+		file << "{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":"
+			<< buffer.id << ",\"args\":{\"name\":\""
+			<< (buffer.id == 1 ? "main" : "worker") << " " << buffer.id << "\"}}";
+
+		for (j = 0; j < buffer.events.size(); j++)
+		{
+			const Event& event(buffer.events[j]);
+			file << ",\n{\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer.id
+				<< ",\"cat\":\"" << event.category
+				<< "\",\"name\":\"" << EscapeJson(event.name) << "\",\"ts\":";
+			WriteTime(file, event.start);
+			file << ",\"dur\":";
+			WriteTime(file, event.duration);
+			if (!event.arguments.empty())
+				file << ",\"args\":{" << event.arguments << "}";
+			file << "}";
+		}
+	}
+
+	file << "\n]}\n";
+	return file.good();
+}
@@ -0,0 +1,52 @@
+// File:  traceRecorder.h
+// Date:  10/18/2026
+// Auth:  agent
+// Desc:  Records timed spans and writes them in Chrome's trace event format
+//        (viewable in Perfetto or chrome://tracing).
+
+#ifndef TRACE_RECORDER_H_
+#define TRACE_RECORDER_H_
+
+// Standard C++ headers
+#include <string>
+#include <chrono>
+
+class TraceRecorder
+{
+public:
+	// Nothing is recorded unless enabled
+	static void Enable();
+	static bool IsEnabled() { return enabled; }
+
+	// Writes every span that has ended so far
+	static bool Write(const std::string& fileName);
+
+	// Records the lifetime of the object as a span on the current thread
+	class Span
+	{
+	public:
+		Span(const char* category, const std::string& name);
+		~Span();
+
+		bool IsActive() const { return active; }
+
+		void AddArgument(const char* key, const std::string& value);
+		void AddArgument(const char* key, const long long& value);
+
+	private:
+		const bool active;
+		const char* const category;
+		std::string name;
+		std::string arguments;// JSON members
+		const std::chrono::steady_clock::time_point start;
+
+		Span(const Span&);
+		Span& operator=(const Span&);
+	};
+
+private:
+	static bool enabled;
+	static std::chrono::steady_clock::time_point startTime;
+};
+
+#endif// TRACE_RECORDER_H_
@@ -0,0 +1,376 @@
+// File:  workTreeScanner.cpp
+// Date:  10/18/2026
+// Auth:  agent
+// Desc:  Finds unstaged and staged changes without starting git.
+
+// Standard C/C++ headers
+#include <cerrno>
+#include <cstdlib>
+#include <cctype>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <sys/stat.h>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#ifdef __APPLE__
+#define st_mtim st_mtimespec
+#define st_ctim st_ctimespec
+#endif
+
+// Local headers
+#include "workTreeScanner.h"
+#include "jobLimiter.h"
+#include "refStore.h"
+#include "objectStore.h"
+#include "sha1.h"
+#include "stringUtilities.h"
+
+WorkTreeScanner::WorkTreeScanner(JobLimiter* jobLimiter) : jobLimiter(jobLimiter)
+{
+	hasConflicts = false;
+	trustFileMode = true;
+	contentMayBeFiltered = false;
+	rootFd = -1;
+}
+
+WorkTreeScanner::Result WorkTreeScanner::FindStagedChange(const std::string& path) const
+{
+	// A valid cache-tree root is the tree a commit would record right now
+	std::string cacheTreeRoot;
+	if (!index.GetCacheTreeRoot(cacheTreeRoot))
+		return ResultUnknown;
+
+	RefStore refStore;
+	if (!refStore.Read(path))
+		return ResultUnknown;
+
+	const std::string head(ObjectStore::FromHex(refStore.Resolve("HEAD")));
+	ObjectStore objects(refStore.GetCommonDirectory());
+	std::string headTree;
+	if (head.empty() || !objects.GetCommitTree(head, headTree))
+		return ResultUnknown;
+
+	return headTree.compare(cacheTreeRoot) == 0 ? ResultClean : ResultModified;
+}
+
+#ifdef _WIN32
+
+WorkTreeScanner::Result WorkTreeScanner::FindUnstagedChange(const std::string&)
+{
+	return ResultUnknown;
+}
+
+#else
+
+WorkTreeScanner::Result WorkTreeScanner::FindUnstagedChange(const std::string& path)
+{
+	std::string gitDirectory, commonDirectory;
+	if (!RefStore::FindGitDirectory(path, gitDirectory, commonDirectory) ||
+		!ReadSettings(gitDirectory, commonDirectory) ||
+		!index.Read(gitDirectory + "index"))
+		return ResultUnknown;
+
+	// Split and sparse indexes don't list every path in this file
+	if (index.HasExtension("link") || index.HasExtension("sdir"))
+		return ResultUnknown;
+
+	const std::vector<IndexFile::Entry>& entries(index.GetEntries());
+	const std::string attributesName(".gitattributes");
+	hasConflicts = false;
+	unsigned int i;
+	for (i = 0; i < entries.size(); i++)
+	{
+		if (entries[i].GetStage() != 0)
+			hasConflicts = true;
+
+		const std::string& entryPath(entries[i].path);
+		if (entryPath.length() >= attributesName.length() &&
+			entryPath.compare(entryPath.length() - attributesName.length(),
+			attributesName.length(), attributesName) == 0)
+			contentMayBeFiltered = true;
+	}
+
+	rootFd = open(path.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+	if (rootFd < 0)
+		return ResultUnknown;
+
+	// Chunks are large enough that starting a thread for one is worthwhile;
+	// once any chunk finds a change the rest give up
+	const size_t chunkSize(4096);
+	const unsigned int chunkCount((entries.size() + chunkSize - 1) / chunkSize);
+	stop = false;
+	chunkResult = ResultClean;
+	auto scanChunk = [this, &path, &entries, chunkSize](const unsigned int& chunk)
+	{
+		const size_t end(std::min(entries.size(), (chunk + 1) * chunkSize));
+		size_t j;
+		for (j = chunk * chunkSize; j < end && !stop; j++)
+		{
+			const Result result(CheckEntry(path, entries[j]));
+			if (result != ResultClean)
+			{
+				int expected(ResultClean);
+				chunkResult.compare_exchange_strong(expected, result);
+				stop = true;
+			}
+		}
+	};
+
+	if (jobLimiter)
+		jobLimiter->ForEach(chunkCount, scanChunk);
+	else
+	{
+		for (i = 0; i < chunkCount; i++)
+			scanChunk(i);
+	}
+
+	close(rootFd);
+	rootFd = -1;
+	return static_cast<Result>(chunkResult.load());
+}
+
+WorkTreeScanner::Result WorkTreeScanner::CheckEntry(const std::string& path,
+	const IndexFile::Entry& entry) const
+{
+	// Conflicts are reported separately, and git doesn't look at files it
+	// has been told not to check out or to assume unchanged
+	if (entry.GetStage() != 0 || entry.IsSkipWorktree() || entry.IsAssumeValid())
+		return ResultClean;
+	else if (entry.IsIntentToAdd())
+		return ResultModified;
+	else if (entry.IsGitlink())
+		return CheckGitlink(path, entry);
+
+	struct stat info;
+	if (fstatat(rootFd, entry.path.c_str(), &info, AT_SYMLINK_NOFOLLOW) != 0)
+		return errno == ENOENT || errno == ENOTDIR ? ResultModified : ResultUnknown;
+
+	const bool isLink((entry.mode & 0170000) == 0120000);
+	if (isLink ? !S_ISLNK(info.st_mode) : !S_ISREG(info.st_mode))
+		return ResultModified;
+	if (!isLink && trustFileMode &&
+		((info.st_mode & S_IXUSR) != 0) != ((entry.mode & 0100) != 0))
+		return ResultModified;
+
+	// The index holds the low 32 bits of each value
+	const bool statMatches(
+		entry.mtimeSeconds == static_cast<uint32_t>(info.st_mtim.tv_sec) &&
+		entry.mtimeNanoseconds == static_cast<uint32_t>(info.st_mtim.tv_nsec) &&
+		entry.ctimeSeconds == static_cast<uint32_t>(info.st_ctim.tv_sec) &&
+		entry.ctimeNanoseconds == static_cast<uint32_t>(info.st_ctim.tv_nsec) &&
+		entry.inode == static_cast<uint32_t>(info.st_ino) &&
+		entry.size == static_cast<uint32_t>(info.st_size));
+	if (statMatches && !IsRacy(entry))
+		return ResultClean;
+
+	// A different size means different contents, unless a filter converts
+	// them or git zeroed the size because the entry was racily clean
+	if (!statMatches && !contentMayBeFiltered && entry.size != 0 &&
+		entry.size != static_cast<uint32_t>(info.st_size))
+		return ResultModified;
+
+	return CompareContents(entry, isLink);
+}
+
+bool WorkTreeScanner::IsRacy(const IndexFile::Entry& entry) const
+{
+	// Files modified in the same instant the index was written may have
+	// changed without their stat data changing
+	return entry.mtimeSeconds > index.GetFileSeconds() ||
+		(entry.mtimeSeconds == index.GetFileSeconds() &&
+		entry.mtimeNanoseconds >= index.GetFileNanoseconds());
+}
+
+WorkTreeScanner::Result WorkTreeScanner::CompareContents(
+	const IndexFile::Entry& entry, const bool& isLink) const
+{
+	if (isLink)
+	{
+		char target[4096];
+		const ssize_t length(readlinkat(rootFd, entry.path.c_str(), target, sizeof(target)));
+		if (length < 0 || length == sizeof(target))
+			return ResultUnknown;
+
+		return Sha1::HashBlob(std::string(target, length)).compare(entry.objectId) == 0 ?
+			ResultClean : ResultModified;
+	}
+	else if (contentMayBeFiltered)
+		return ResultUnknown;
+
+	const int fd(openat(rootFd, entry.path.c_str(), O_RDONLY | O_CLOEXEC | O_NOFOLLOW));
+	if (fd < 0)
+		return ResultUnknown;
+
+	struct stat info;
+	if (fstat(fd, &info) != 0)
+	{
+		close(fd);
+		return ResultUnknown;
+	}
+
+	std::ostringstream header;
+	header << "blob " << info.st_size;
+	Sha1 sha;
+	sha.Update(header.str().c_str(), header.str().length() + 1);// Includes the NUL
+
+	char buffer[65536];
+	ssize_t count;
+	off_t total(0);
+	while ((count = read(fd, buffer, sizeof(buffer))) > 0)
+	{
+		sha.Update(buffer, count);
+		total += count;
+	}
+	close(fd);
+
+	// Changed while we were reading it
+	if (count < 0 || total != info.st_size)
+		return ResultModified;
+
+	return sha.Finish().compare(entry.objectId) == 0 ? ResultClean : ResultModified;
+}
+
+WorkTreeScanner::Result WorkTreeScanner::CheckGitlink(const std::string& path,
+	const IndexFile::Entry& entry)
+{
+	// Only a new commit counts (as with --ignore-submodules=dirty), and
+	// submodules that haven't been initialized are never modified
+	const std::string subModulePath(path + entry.path + "/");
+	std::string gitDirectory, commonDirectory;
+	if (!RefStore::FindGitDirectory(subModulePath, gitDirectory, commonDirectory))
+		return ResultClean;
+
+	RefStore refStore;
+	if (!refStore.Read(subModulePath))
+		return ResultUnknown;
+
+	const std::string head(refStore.Resolve("HEAD"));
+	if (head.empty())
+		return ResultUnknown;
+
+	return ObjectStore::ToHex(entry.objectId).compare(head) == 0 ? ResultClean : ResultModified;
+}
+
+#endif
+
+bool WorkTreeScanner::ReadSettings(const std::string& gitDirectory,
+	const std::string& commonDirectory)
+{
+	// Later files override earlier ones, as with git
+	std::map<std::string, std::string> values;
+	const char* home(getenv("HOME"));
+	const char* xdgConfigHome(getenv("XDG_CONFIG_HOME"));
+	const std::string xdgDirectory(xdgConfigHome ? std::string(xdgConfigHome) + "/git/" :
+		(home ? std::string(home) + "/.config/git/" : std::string()));
+
+	ReadConfig("/etc/gitconfig", values);
+	if (!xdgDirectory.empty())
+		ReadConfig(xdgDirectory + "config", values);
+	if (home)
+		ReadConfig(std::string(home) + "/.gitconfig", values);
+	ReadConfig(commonDirectory + "config", values);
+	ReadConfig(gitDirectory + "config.worktree", values);
+
+	std::map<std::string, std::string>::const_iterator it;
+	for (it = values.begin(); it != values.end(); ++it)
+	{
+		// Anything that could change the settings below, or that we don't
+		// understand, means git has to answer
+		if (it->first.compare(0, 7, "include") == 0)
+			return false;
+	}
+
+	auto isFalse = [](const std::string& value)
+	{
+		return value.compare("false") == 0 || value.compare("no") == 0 ||
+			value.compare("off") == 0 || value.compare("0") == 0;
+	};
+
+	it = values.find("extensions.objectformat");
+	if (it != values.end() && it->second.compare("sha1") != 0)
+		return false;
+
+	it = values.find("core.symlinks");
+	if (it != values.end() && isFalse(it->second))
+		return false;
+
+	it = values.find("core.filemode");
+	trustFileMode = it == values.end() || !isFalse(it->second);
+
+	// Line ending conversion and filters (which need attributes) change the
+	// contents git hashes
+	it = values.find("core.autocrlf");
+	contentMayBeFiltered = (it != values.end() && !isFalse(it->second)) ||
+		values.find("core.eol") != values.end() ||
+		values.find("core.attributesfile") != values.end();
+
+	struct stat info;
+	if (stat((commonDirectory + "info/attributes").c_str(), &info) == 0 ||
+		(!xdgDirectory.empty() && stat((xdgDirectory + "attributes").c_str(), &info) == 0))
+		contentMayBeFiltered = true;
+
+	return true;
+}
+
+bool WorkTreeScanner::ReadConfig(const std::string& fileName,
+	std::map<std::string, std::string>& values)
+{
+	std::ifstream file(fileName.c_str());
+	if (!file.is_open())
+		return false;
+
+	auto toLower = [](std::string s)
+	{
+		std::transform(s.begin(), s.end(), s.begin(), [](const unsigned char& c)
+		{
+			return static_cast<char>(std::tolower(c));
+		});
+		return s;
+	};
+
+	// Values are only needed for a few simple settings, so quoting and
+	// escapes within values are not interpreted
+	std::string section, line;
+	while (std::getline(file, line))
+	{
+		line = Trim(line);
+		if (line.empty() || line[0] == '#' || line[0] == ';')
+			continue;
+
+		if (line[0] == '[')
+		{
+			const size_t end(line.find(']'));
+			if (end == std::string::npos)
+				return false;
+
+			// Subsection names are case sensitive
+			std::string name(Trim(line.substr(1, end - 1)));
+			const size_t quote(name.find('"'));
+			if (quote != std::string::npos)
+				section = toLower(Trim(name.substr(0, quote))) + "." +
+					name.substr(quote + 1, name.rfind('"') - quote - 1);
+			else
+				section = toLower(name);
+			continue;
+		}
+
+		const size_t equals(line.find('='));
+		const std::string key(toLower(Trim(line.substr(0, equals))));
+		std::string value(equals == std::string::npos ? "true" :
+			Trim(line.substr(equals + 1)));
+		const size_t comment(value.find_first_of("#;"));
+		if (comment != std::string::npos)
+			value = Trim(value.substr(0, comment));
+		if (value.length() >= 2 && value[0] == '"' && value[value.length() - 1] == '"')
+			value = value.substr(1, value.length() - 2);
+
+		values[section + "." + key] = toLower(value);
+	}
+
+	return true;
+}
@@ -0,0 +1,69 @@
+// File:  workTreeScanner.h
+// Date:  10/18/2026
+// Auth:  agent
+// Desc:  Finds unstaged and staged changes by comparing the index with the
+//        working tree and with HEAD, without starting git.
+
+#ifndef WORK_TREE_SCANNER_H_
+#define WORK_TREE_SCANNER_H_
+
+// Standard C++ headers
+#include <string>
+#include <map>
+#include <atomic>
+
+// Local headers
+#include "indexFile.h"
+
+class JobLimiter;
+
+class WorkTreeScanner
+{
+public:
+	// Stat calls are spread over free job slots (optional)
+	explicit WorkTreeScanner(JobLimiter* jobLimiter = NULL);
+
+	enum Result
+	{
+		ResultClean,
+		ResultModified,// At least one tracked file differs
+		ResultUnknown// Can't be determined without git
+	};
+
+	// Stops at the first modification found
+	Result FindUnstagedChange(const std::string& path);
+
+	// Compares the index with HEAD; requires a prior scan and ignores
+	// conflicts
+	Result FindStagedChange(const std::string& path) const;
+
+	// Valid after a scan that didn't return ResultUnknown
+	const IndexFile& GetIndex() const { return index; }
+	bool HasConflicts() const { return hasConflicts; }
+
+private:
+	JobLimiter* const jobLimiter;
+
+	IndexFile index;
+	bool hasConflicts;
+
+	// Settings that change what counts as a modification
+	bool trustFileMode;
+	bool contentMayBeFiltered;// Hashing the file may not give the blob's ID
+
+	int rootFd;
+	std::atomic<bool> stop;
+	std::atomic<int> chunkResult;
+
+	bool ReadSettings(const std::string& gitDirectory,
+		const std::string& commonDirectory);
+	static bool ReadConfig(const std::string& fileName,
+		std::map<std::string, std::string>& values);
+
+	Result CheckEntry(const std::string& path, const IndexFile::Entry& entry) const;
+	bool IsRacy(const IndexFile::Entry& entry) const;
+	Result CompareContents(const IndexFile::Entry& entry, const bool& isLink) const;
+	static Result CheckGitlink(const std::string& path, const IndexFile::Entry& entry);
+};
+
+#endif// WORK_TREE_SCANNER_H_